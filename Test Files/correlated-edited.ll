@@ -0,0 +1,56 @@
+; correlated.ll with a different exit condition in @counted, which its caller must be explored again for
+define i32 @correlated(i32 %x) {
+entry:
+  %big = icmp sgt i32 %x, 5
+  br i1 %big, label %above, label %below
+above:
+  %tiny = icmp slt i32 %x, 3
+  br i1 %tiny, label %dead, label %join
+below:
+  %ten = icmp eq i32 %x, 10
+  br i1 %ten, label %dead, label %join
+dead:
+  br label %join
+join:
+  %seven = icmp eq i32 %x, 7
+  br i1 %seven, label %exit, label %other
+other:
+  br label %exit
+exit:
+  ret i32 0
+}
+
+define i32 @counted(i32 %n) {
+entry:
+  br label %loop
+loop:
+  %i = phi i32 [ 0, %entry ], [ %next, %body ]
+  %more = icmp slt i32 %i, 2
+  br i1 %more, label %body, label %done
+body:
+  %next = add i32 %i, 1
+  br label %loop
+done:
+  %five = icmp eq i32 %i, 5
+  br i1 %five, label %exit, label %dead
+dead:
+  unreachable
+exit:
+  ret i32 %i
+}
+
+define i32 @caller(i32 %x) {
+entry:
+  %r = call i32 @correlated(i32 %x)
+  %c = call i32 @counted(i32 %x)
+  %sum = add i32 %r, %c
+  %positive = icmp sgt i32 %x, 0
+  br i1 %positive, label %check, label %exit
+check:
+  %negative = icmp slt i32 %x, 0
+  br i1 %negative, label %dead, label %exit
+dead:
+  unreachable
+exit:
+  ret i32 %sum
+}
@@ -0,0 +1,38 @@
+; Phis entered around a loop back edge: one reading the block it is in, and two swapping their values
+define i32 @selfloop(i32 %n) {
+entry:
+  br label %loop
+loop:
+  %i = phi i32 [ 0, %entry ], [ %next, %loop ]
+  %next = add i32 %i, 1
+  %c = icmp slt i32 %next, 2
+  br i1 %c, label %loop, label %out
+out:
+  %r = icmp eq i32 %i, 1
+  br i1 %r, label %yes, label %no
+yes:
+  ret i32 1
+no:
+  ret i32 0
+}
+
+define i32 @swap(i32 %a, i32 %b) {
+entry:
+  br label %loop
+loop:
+  %x = phi i32 [ %a, %entry ], [ %y, %latch ]
+  %y = phi i32 [ %b, %entry ], [ %x, %latch ]
+  %k = phi i32 [ 0, %entry ], [ %k1, %latch ]
+  br label %latch
+latch:
+  %k1 = add i32 %k, 1
+  %c = icmp slt i32 %k1, 2
+  br i1 %c, label %loop, label %out
+out:
+  %e = icmp eq i32 %y, %a
+  br i1 %e, label %yes, label %no
+yes:
+  ret i32 1
+no:
+  ret i32 0
+}
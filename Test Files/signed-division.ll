@@ -0,0 +1,38 @@
+; C rounds signed division toward zero: -7 / 2 == -3 and -7 % 2 == -1, 7 / -2 == -3 and 7 % -2 == 1
+define i32 @sdiv_negative_dividend(i32 %a, i32 %b) {
+entry:
+  %ca = icmp eq i32 %a, -7
+  %cb = icmp eq i32 %b, 2
+  %c = and i1 %ca, %cb
+  br i1 %c, label %check, label %other
+check:
+  %q = sdiv i32 %a, %b
+  %r = srem i32 %a, %b
+  %cq = icmp eq i32 %q, -3
+  %cr = icmp eq i32 %r, -1
+  %ok = and i1 %cq, %cr
+  br i1 %ok, label %other, label %wrong
+wrong:
+  unreachable
+other:
+  ret i32 0
+}
+
+define i32 @sdiv_negative_divisor(i32 %a, i32 %b) {
+entry:
+  %ca = icmp eq i32 %a, 7
+  %cb = icmp eq i32 %b, -2
+  %c = and i1 %ca, %cb
+  br i1 %c, label %check, label %other
+check:
+  %q = sdiv i32 %a, %b
+  %r = srem i32 %a, %b
+  %cq = icmp eq i32 %q, -3
+  %cr = icmp eq i32 %r, 1
+  %ok = and i1 %cq, %cr
+  br i1 %ok, label %other, label %wrong
+wrong:
+  unreachable
+other:
+  ret i32 0
+}
@@ -0,0 +1,17 @@
+; A store through a pointer that may be the local or an address made from an integer (a black hole target for the
+; points-to analysis) must be visible to loads of the local
+define i32 @may_point_anywhere(i1 %c, i64 %addr, i32 %v) {
+entry:
+  %local = alloca i32
+  store i32 1, i32* %local
+  %forged = inttoptr i64 %addr to i32*
+  %p = select i1 %c, i32* %local, i32* %forged
+  store i32 %v, i32* %p
+  %x = load i32, i32* %local
+  %changed = icmp eq i32 %x, 2
+  br i1 %changed, label %exit, label %same
+same:
+  unreachable
+exit:
+  ret i32 0
+}
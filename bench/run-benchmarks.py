@@ -0,0 +1,296 @@
+#!/usr/bin/env python3
+"""Scaling benchmarks of svf-ex on generated workloads.
+
+Every workload is a C file generated from a family and a size, compiled with clang the way the README compiles
+example.c and analyzed by svf-ex with -profile-json. The phase times, counters and peak RSS of each run are collected
+into one JSON baseline. Given an earlier baseline with --compare, workloads that got slower, call the solver more often
+or use more memory by more than --tolerance are reported and the script exits with status 1.
+
+Families:
+  branches   N sequential independent branches, 2^N paths
+  diamonds   diamonds nested N deep, 2^N paths through as many blocks
+  loops      N sequential loops with a symbolic bound and a branch inside
+  arith      a chain of N mul/sdiv steps on symbolic values, with a branch every few steps
+  functions  N functions per module, each calling two earlier ones
+"""
+
+import argparse
+import json
+import os
+import re
+import statistics
+import subprocess
+import sys
+import time
+
+BASELINE_VERSION = 1
+
+DEFAULT_SIZES = {
+    "branches": [4, 8, 12],
+    "diamonds": [3, 6, 9],
+    "loops": [1, 2, 4],
+    "arith": [4, 8, 16],
+    "functions": [16, 64, 256],
+}
+
+# Metrics compared against a baseline, with whether a higher value is worse
+COMPARED_METRICS = [
+    ("wallSeconds", True),
+    ("pathsPerSecond", False),
+    ("solverCalls", True),
+    ("peakRss", True),
+]
+
+TIME_METRICS = {"wallSeconds", "pathsPerSecond"}
+
+
+def params(count, prefix="x"):
+    return ", ".join("int %s%d" % (prefix, i) for i in range(count))
+
+
+def generate_branches(n):
+    lines = ["int bench(%s) {" % params(n), "    int s = 0;"]
+    for i in range(n):
+        lines.append("    if (x%d > %d) {" % (i, i))
+        lines.append("        s += %d;" % (i + 1))
+        lines.append("    } else {")
+        lines.append("        s -= %d;" % (i + 1))
+        lines.append("    }")
+    lines += ["    return s;", "}"]
+    return lines
+
+
+def generate_diamonds(n):
+    def nested(depth, indent):
+        pad = "    " * indent
+        if depth == n:
+            return []
+        body = [pad + "if (x%d > %d) {" % (depth, depth), pad + "    s += %d;" % (depth + 1)]
+        body += nested(depth + 1, indent + 1)
+        body += [pad + "} else {", pad + "    s -= %d;" % (depth + 1)]
+        body += nested(depth + 1, indent + 1)
+        body += [pad + "}"]
+        return body
+
+    lines = ["int bench(%s) {" % params(n), "    int s = 0;"]
+    lines += nested(0, 1)
+    lines += ["    return s;", "}"]
+    return lines
+
+
+def generate_loops(n):
+    lines = ["int bench(%s) {" % params(n, "n"), "    int s = 0;"]
+    for i in range(n):
+        lines.append("    for (int i%d = 0; i%d < n%d; i%d++) {" % (i, i, i, i))
+        lines.append("        s += i%d * %d;" % (i, i + 2))
+        lines.append("        if (s > %d) {" % (100 * (i + 1)))
+        lines.append("            s -= %d;" % (i + 7))
+        lines.append("        }")
+        lines.append("    }")
+    lines += ["    return s;", "}"]
+    return lines
+
+
+def generate_arith(n):
+    lines = ["int bench(int a, int b, int c) {", "    int v = a;"]
+    for i in range(n):
+        if i % 2 == 0:
+            lines.append("    v = v * (b | 1) + %d;" % (i + 1))
+        else:
+            lines.append("    v = v / (c | 1) - %d;" % (i + 1))
+        if i % 4 == 3:
+            lines.append("    if (v < %d) {" % (i * 10))
+            lines.append("        v = -v;")
+            lines.append("    }")
+    lines += ["    if (v == 42) {", "        return 1;", "    }", "    return 0;", "}"]
+    return lines
+
+
+def generate_functions(n):
+    lines = ["int f0(int x) {", "    if (x > 0) {", "        return x;", "    }", "    return -x;", "}"]
+    for i in range(1, n):
+        lines.append("")
+        lines.append("int f%d(int x) {" % i)
+        lines.append("    if (x > %d) {" % i)
+        lines.append("        return f%d(x - %d) + 1;" % (i - 1, i))
+        lines.append("    }")
+        lines.append("    return f%d(x) * 2;" % (i // 2))
+        lines.append("}")
+    return lines
+
+
+GENERATORS = {
+    "branches": generate_branches,
+    "diamonds": generate_diamonds,
+    "loops": generate_loops,
+    "arith": generate_arith,
+    "functions": generate_functions,
+}
+
+
+def write_workload(work_dir, family, size):
+    name = "%s-%d" % (family, size)
+    source = os.path.join(work_dir, name + ".c")
+    header = "/* Generated by bench/run-benchmarks.py: %s workload of size %d */" % (family, size)
+    with open(source, "w") as out:
+        out.write("\n".join([header, ""] + GENERATORS[family](size)) + "\n")
+    return name, source
+
+
+def compile_workload(clang, source):
+    module = os.path.splitext(source)[0] + ".ll"
+    subprocess.run([clang, "-S", "-c", "-g", "-fno-discard-value-names", "-emit-llvm", source, "-o", module],
+                   check=True)
+    return module
+
+
+def run_once(svf_ex, module, extra_args, timeout):
+    """Runs svf-ex once, returning the wall time and the parsed profile, or None for the profile on a timeout"""
+    profile = module + ".profile.json"
+    if os.path.exists(profile):
+        os.remove(profile)
+    command = [svf_ex, "-output-format=quiet", "-profile-json=" + profile] + extra_args + [module]
+    start = time.monotonic()
+    try:
+        subprocess.run(command, check=True, stdout=subprocess.DEVNULL, timeout=timeout)
+    except subprocess.TimeoutExpired:
+        return time.monotonic() - start, None
+    wall = time.monotonic() - start
+    with open(profile) as f:
+        return wall, json.load(f)
+
+
+def measure(svf_ex, name, family, size, module, extra_args, repeat, timeout):
+    runs = []
+    for _ in range(repeat):
+        wall, profile = run_once(svf_ex, module, extra_args, timeout)
+        if profile is None:
+            return {"name": name, "family": family, "size": size, "status": "timeout", "wallSeconds": wall}
+        runs.append((wall, profile))
+
+    # The run with the median wall time stands for the workload, so its phases and counters agree with each other
+    runs.sort(key=lambda run: run[0])
+    wall, profile = runs[len(runs) // 2]
+    counters = profile["counters"]
+    phases = profile["phases"]
+    exploration = phases.get("exploration", 0.0)
+    return {
+        "name": name,
+        "family": family,
+        "size": size,
+        "status": "ok",
+        "wallSeconds": wall,
+        "wallSecondsMin": runs[0][0],
+        "wallSecondsStdev": statistics.pstdev(run[0] for run in runs),
+        "pathsPerSecond": counters["pathsExplored"] / exploration if exploration > 0 else 0.0,
+        "solverCalls": counters["solverCalls"],
+        "peakRss": counters["peakRss"],
+        "phases": phases,
+        "counters": counters,
+        "solverHistogram": profile["solverHistogram"],
+    }
+
+
+def compare(baseline, results, tolerance, min_seconds):
+    """Prints how every workload changed against baseline; returns the number of regressions"""
+    previous = {workload["name"]: workload for workload in baseline["workloads"]}
+    regressions = 0
+    for workload in results:
+        before = previous.get(workload["name"])
+        if before is None:
+            continue
+        if workload["status"] != "ok" or before["status"] != "ok":
+            if workload["status"] != before["status"]:
+                print("%-16s %s, was %s" % (workload["name"], workload["status"], before["status"]))
+                regressions += workload["status"] != "ok"
+            continue
+        if workload["counters"]["pathsExplored"] != before["counters"]["pathsExplored"]:
+            print("%-16s explores %d paths, was %d" % (workload["name"], workload["counters"]["pathsExplored"],
+                                                       before["counters"]["pathsExplored"]))
+        # Times too short to measure reliably are not compared
+        timed = max(workload["wallSeconds"], before["wallSeconds"]) >= min_seconds
+        for metric, higher_is_worse in COMPARED_METRICS:
+            if metric in TIME_METRICS and not timed:
+                continue
+            old, new = before[metric], workload[metric]
+            if old <= 0:
+                continue
+            change = (new - old) / old
+            worse = change > tolerance if higher_is_worse else change < -tolerance
+            if worse:
+                regressions += 1
+                print("%-16s %-16s %12.4g -> %-12.4g (%+.0f%%) REGRESSION"
+                      % (workload["name"], metric, old, new, change * 100))
+    return regressions
+
+
+def parse_workloads(specs):
+    """Families and sizes from family[:size,size...] specs, by default every family at its default sizes"""
+    if not specs:
+        return [(family, size) for family in GENERATORS for size in DEFAULT_SIZES[family]]
+    workloads = []
+    for spec in specs:
+        family, _, sizes = spec.partition(":")
+        if family not in GENERATORS:
+            raise SystemExit("Unknown workload family %s, expected one of %s" % (family, ", ".join(GENERATORS)))
+        for size in sizes.split(",") if sizes else DEFAULT_SIZES[family]:
+            workloads.append((family, int(size)))
+    return workloads
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--svf-ex", default="bin/svf-ex", help="svf-ex executable (default: %(default)s)")
+    parser.add_argument("--clang", default="clang", help="clang used to compile the workloads (default: %(default)s)")
+    parser.add_argument("--work-dir", default="bench-work", help="Directory of the generated workloads")
+    parser.add_argument("--output", default="baseline.json", help="File the results are written to")
+    parser.add_argument("--compare", metavar="BASELINE", help="Report regressions against an earlier baseline")
+    parser.add_argument("--tolerance", type=float, default=0.25,
+                        help="Relative change of a metric counted as a regression (default: %(default)s)")
+    parser.add_argument("--min-seconds", type=float, default=0.1,
+                        help="Shortest run whose times are compared (default: %(default)s)")
+    parser.add_argument("--workload", action="append", metavar="FAMILY[:SIZES]",
+                        help="Run only this family, at the given comma separated sizes; may be repeated")
+    parser.add_argument("--repeat", type=int, default=3, help="Runs per workload, the median is kept")
+    parser.add_argument("--timeout", type=float, default=300, help="Seconds a run may take")
+    parser.add_argument("svf_ex_args", nargs="*", help="Extra svf-ex options, after --")
+    args = parser.parse_args()
+
+    os.makedirs(args.work_dir, exist_ok=True)
+    results = []
+    for family, size in parse_workloads(args.workload):
+        name, source = write_workload(args.work_dir, family, size)
+        module = compile_workload(args.clang, source)
+        result = measure(args.svf_ex, name, family, size, module, args.svf_ex_args, args.repeat, args.timeout)
+        results.append(result)
+        if result["status"] == "ok":
+            print("%-16s %8.3f s %10.1f paths/s %8d solver calls %8.1f MiB"
+                  % (name, result["wallSeconds"], result["pathsPerSecond"], result["solverCalls"],
+                     result["peakRss"] / float(1 << 20)))
+        else:
+            print("%-16s %s after %.0f s" % (name, result["status"], result["wallSeconds"]))
+
+    baseline = {
+        "version": BASELINE_VERSION,
+        "svfExArgs": args.svf_ex_args,
+        "repeat": args.repeat,
+        "workloads": results,
+    }
+    with open(args.output, "w") as out:
+        json.dump(baseline, out, indent=2, sort_keys=True)
+        out.write("\n")
+
+    if args.compare:
+        with open(args.compare) as f:
+            previous = json.load(f)
+        if previous.get("version") != BASELINE_VERSION or previous.get("svfExArgs") != args.svf_ex_args:
+            print("Baseline %s was recorded with another format or other svf-ex options" % args.compare)
+            return 1
+        regressions = compare(previous, results, args.tolerance, args.min_seconds)
+        print("%d regression(s) against %s" % (regressions, args.compare))
+        return 1 if regressions else 0
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
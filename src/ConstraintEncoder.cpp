@@ -0,0 +1,837 @@
+//===- ConstraintEncoder.cpp -- Z3 encoding of ICFG nodes and edges ---------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+#include "ConstraintEncoder.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/GetElementPtrTypeIterator.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <mutex>
+
+using namespace SVF;
+using namespace llvm;
+using namespace z3;
+
+/// Width of pointers in the bitvector theory
+static const unsigned POINTER_WIDTH = 64;
+
+/// Concrete addresses hold the object ID + 1 above this bit and the offset into the object below it
+static const unsigned OBJECT_SHIFT = 32;
+
+
+void ConstraintEncoder::encodeNode(const ICFGNode* node, SymbolicState& state, ConstraintList& constraints) {
+    const IntraBlockNode* intraNode = SVFUtil::dyn_cast<IntraBlockNode>(node);
+    if (intraNode == nullptr) {
+        // Entry/exit/return nodes define no value themselves and calls are encoded by FunctionSummaries; formal
+        // parameters become fresh symbols the first time they are used
+        return;
+    }
+
+    // Blocks are entered through encodeEdge(), except the first one of a function
+    const BasicBlock* bb = intraNode->getInst()->getParent();
+    if (bb != state.current_block) {
+        state.incoming_block = nullptr;
+        state.current_block = bb;
+    }
+    encodeInstruction(intraNode->getInst(), state, constraints);
+}
+
+
+bool ConstraintEncoder::encodeEdge(const ICFGEdge* edge, SymbolicState& state, expr& cond) {
+    const IntraBlockNode* srcNode = SVFUtil::dyn_cast<IntraBlockNode>(edge->getSrcNode());
+    if (srcNode == nullptr) {
+        return false;
+    }
+    const BasicBlock* dstBB = edge->getDstNode()->getBB();
+    // Every edge out of a terminator enters a block, including a loop back into the block of the terminator
+    if (srcNode->getInst()->isTerminator()) {
+        state.incoming_block = srcNode->getInst()->getParent();
+        state.current_block = dstBB;
+    }
+
+    if (const BranchInst* br = SVFUtil::dyn_cast<BranchInst>(srcNode->getInst())) {
+        if (!br->isConditional() || br->getSuccessor(0) == br->getSuccessor(1)) {
+            return false;
+        }
+        expr branchCond = toBool(getValue(br->getCondition(), state));
+        cond = dstBB == br->getSuccessor(0) ? branchCond : !branchCond;
+        return true;
+    }
+
+    if (const SwitchInst* sw = SVFUtil::dyn_cast<SwitchInst>(srcNode->getInst())) {
+        expr switchValue = getValue(sw->getCondition(), state);
+        expr matchesCase = ctx.bool_val(false);
+        expr matchesNoOtherCase = ctx.bool_val(true);
+        for (auto caseIt : sw->cases()) {
+            expr isCase = switchValue == getValue(caseIt.getCaseValue(), state);
+            if (caseIt.getCaseSuccessor() == dstBB) {
+                matchesCase = matchesCase || isCase;
+            } else {
+                matchesNoOtherCase = matchesNoOtherCase && !isCase;
+            }
+        }
+        cond = sw->getDefaultDest() == dstBB ? matchesCase || matchesNoOtherCase : matchesCase;
+        return true;
+    }
+    return false;
+}
+
+
+expr ConstraintEncoder::getValue(const Value* v, SymbolicState& state) {
+    if (const ConstantInt* ci = SVFUtil::dyn_cast<ConstantInt>(v)) {
+        if (ci->getBitWidth() == 1) {
+            return ctx.bool_val(ci->isOne());
+        }
+        if (ci->getBitWidth() <= 64) {
+            return theory == IntegerTheory ? ctx.int_val((int64_t) ci->getSExtValue())
+                                           : ctx.bv_val((uint64_t) ci->getZExtValue(), ci->getBitWidth());
+        }
+        // Wider constants, such as i128, do not fit a machine integer and go through their decimal digits
+        SmallString<48> digits;
+        ci->getValue().toString(digits, 10, theory == IntegerTheory);
+        return theory == IntegerTheory ? ctx.int_val(digits.c_str()) : ctx.bv_val(digits.c_str(), ci->getBitWidth());
+    }
+    if (SVFUtil::isa<ConstantPointerNull>(v)) {
+        return theory == IntegerTheory ? ctx.int_val(0) : ctx.bv_val(0, POINTER_WIDTH);
+    }
+    if (SVFUtil::isa<AllocaInst>(v) || SVFUtil::isa<GlobalVariable>(v)) {
+        MemoryRegions::ObjectID object = regions.getObjectId(v);
+        if (object != MemoryRegions::NoObject) {
+            return makeAddress(object, 0);
+        }
+    }
+    if (const ConstantExpr* constExpr = SVFUtil::dyn_cast<ConstantExpr>(v)) {
+        if (const GEPOperator* gep = SVFUtil::dyn_cast<GEPOperator>(constExpr)) {
+            return encodeGEP(gep, state);
+        }
+        if (constExpr->getOpcode() == Instruction::BitCast) {
+            return getValue(constExpr->getOperand(0), state);
+        }
+    }
+
+    ValueIndex::ValueID id = valueIndex.getId(v);
+    expr e(ctx);
+    if (!state.lookupValue(id, e)) {
+        e = freshSymbol(v);
+        state.bindValue(id, e);
+    }
+    return e;
+}
+
+
+void ConstraintEncoder::bindValue(const Value* v, const expr& e, SymbolicState& state) {
+    state.bindValue(valueIndex.getId(v), e);
+}
+
+
+expr ConstraintEncoder::makeSymbol(const Value* v, const std::string& suffix) {
+    return makeSymbol(getSymbolName(v) + suffix, v->getType());
+}
+
+
+expr ConstraintEncoder::makeSymbol(const std::string& name, const Type* type) {
+    return ctx.constant(name.c_str(), getSort(type));
+}
+
+
+void ConstraintEncoder::havocMemory(const CallBase* call, SymbolicState& state) {
+    std::vector<MemoryRegions::RegionID> written(regions.getGlobalRegions());
+    for (const Use& arg : call->args()) {
+        if (!arg->getType()->isPointerTy()) {
+            continue;
+        }
+        const std::vector<MemoryRegions::RegionID>& reachable = regions.getReachableRegions(arg.get());
+        written.insert(written.end(), reachable.begin(), reachable.end());
+        CellID cell;
+        if (getCell(getValue(arg.get(), state), cell)) {
+            written.push_back(cells[cell].region);
+        }
+    }
+    std::sort(written.begin(), written.end());
+    written.erase(std::unique(written.begin(), written.end()), written.end());
+    for (MemoryRegions::RegionID region : written) {
+        havocRegion(region, state);
+    }
+}
+
+
+void ConstraintEncoder::encodeInstruction(const Instruction* inst, SymbolicState& state,
+                                          ConstraintList& constraints) {
+    dataLayout = &inst->getModule()->getDataLayout();
+    switch (inst->getOpcode()) {
+        case Instruction::Store: {
+            const StoreInst* store = SVFUtil::cast<StoreInst>(inst);
+            storeMemory(store->getPointerOperand(), getValue(store->getValueOperand(), state), state);
+            break;
+        }
+        case Instruction::Load: {
+            state.bindValue(valueIndex.getId(inst), loadMemory(SVFUtil::cast<LoadInst>(inst), state));
+            break;
+        }
+        case Instruction::GetElementPtr: {
+            state.bindValue(valueIndex.getId(inst), encodeGEP(SVFUtil::cast<GEPOperator>(inst), state));
+            break;
+        }
+        case Instruction::BitCast: {
+            if (inst->getType()->isPointerTy() && inst->getOperand(0)->getType()->isPointerTy()) {
+                state.bindValue(valueIndex.getId(inst), getValue(inst->getOperand(0), state));
+            }
+            break;
+        }
+        case Instruction::Add:
+        case Instruction::Sub:
+        case Instruction::Mul:
+        case Instruction::SDiv:
+        case Instruction::UDiv:
+        case Instruction::SRem:
+        case Instruction::URem:
+        case Instruction::And:
+        case Instruction::Or:
+        case Instruction::Xor:
+        case Instruction::Shl:
+        case Instruction::LShr:
+        case Instruction::AShr: {
+            expr result = encodeBinaryOperator(SVFUtil::cast<BinaryOperator>(inst), state, constraints);
+            state.bindValue(valueIndex.getId(inst), result);
+            break;
+        }
+        case Instruction::ICmp: {
+            state.bindValue(valueIndex.getId(inst), encodeICmp(SVFUtil::cast<ICmpInst>(inst), state));
+            break;
+        }
+        case Instruction::ZExt:
+        case Instruction::SExt:
+        case Instruction::Trunc: {
+            state.bindValue(valueIndex.getId(inst), encodeCast(SVFUtil::cast<CastInst>(inst), state));
+            break;
+        }
+        case Instruction::Select: {
+            const SelectInst* select = SVFUtil::cast<SelectInst>(inst);
+            expr result = ite(toBool(getValue(select->getCondition(), state)),
+                              getValue(select->getTrueValue(), state),
+                              getValue(select->getFalseValue(), state));
+            state.bindValue(valueIndex.getId(inst), result);
+            break;
+        }
+        case Instruction::PHI: {
+            // The phis of a block all read the values from before it, so the first one binds them together; a phi
+            // reading another one (a swap) gets its value from the previous iteration
+            const BasicBlock* bb = inst->getParent();
+            if (inst != &bb->front()) {
+                break;
+            }
+            std::vector<std::pair<ValueIndex::ValueID, expr>> incoming;
+            for (const PHINode& phi : bb->phis()) {
+                int idx = phi.getBasicBlockIndex(state.incoming_block);
+                // Without a known predecessor the value of the last iteration must not survive
+                expr value = idx >= 0 ? getValue(phi.getIncomingValue(idx), state) : freshSymbol(&phi);
+                incoming.emplace_back(valueIndex.getId(&phi), value);
+            }
+            for (const auto& binding : incoming) {
+                state.bindValue(binding.first, binding.second);
+            }
+            break;
+        }
+        default:
+            // Calls and other instructions define nothing the encoder tracks, their results are symbolic if ever
+            // used. Allocas have their address as value
+            break;
+    }
+}
+
+
+expr ConstraintEncoder::encodeBinaryOperator(const BinaryOperator* binOp, SymbolicState& state,
+                                             ConstraintList& constraints) {
+    expr lhs = getValue(binOp->getOperand(0), state);
+    expr rhs = getValue(binOp->getOperand(1), state);
+    if (theory == BitVectorTheory && lhs.is_bv() && rhs.is_bv()) {
+        return encodeBitVectorOperator(binOp, lhs, rhs, constraints);
+    }
+
+    switch (binOp->getOpcode()) {
+        case Instruction::Add:
+            return lhs + rhs;
+        case Instruction::Sub:
+            return lhs - rhs;
+        case Instruction::Mul:
+            return lhs * rhs;
+        case Instruction::SDiv:
+        case Instruction::SRem: {
+            // A path only continues past a division if it did not divide by zero. Z3 divides integers the Euclidean
+            // way, which only rounds toward zero like C for a non-negative dividend
+            constraints.push_back(rhs != 0);
+            expr quotient = ite(lhs >= 0, lhs / rhs, -((-lhs) / rhs));
+            return binOp->getOpcode() == Instruction::SDiv ? quotient : lhs - rhs * quotient;
+        }
+        case Instruction::UDiv:
+            constraints.push_back(rhs != 0);
+            return lhs / rhs;
+        case Instruction::URem:
+            constraints.push_back(rhs != 0);
+            return rem(lhs, rhs);
+        case Instruction::And:
+            if (lhs.is_bool() && rhs.is_bool()) {
+                return lhs && rhs;
+            }
+            break;
+        case Instruction::Or:
+            if (lhs.is_bool() && rhs.is_bool()) {
+                return lhs || rhs;
+            }
+            break;
+        case Instruction::Xor:
+            if (lhs.is_bool() && rhs.is_bool()) {
+                return lhs != rhs;
+            }
+            break;
+        default:
+            break;
+    }
+    // Bitwise operations and shifts on integers have no exact counterpart in integer arithmetic
+    return freshSymbol(binOp);
+}
+
+
+expr ConstraintEncoder::encodeBitVectorOperator(const BinaryOperator* binOp, const expr& lhs, const expr& rhs,
+                                                ConstraintList& constraints) {
+    unsigned width = lhs.get_sort().bv_size();
+    expr zero = ctx.bv_val(0, width);
+
+    switch (binOp->getOpcode()) {
+        case Instruction::Add:
+            return lhs + rhs;
+        case Instruction::Sub:
+            return lhs - rhs;
+        case Instruction::Mul:
+            return lhs * rhs;
+        case Instruction::SDiv:
+        case Instruction::SRem: {
+            // Dividing by zero and dividing the smallest signed value by -1 are both undefined
+            expr signedMin = shl(ctx.bv_val(1, width), (int) width - 1);
+            constraints.push_back(rhs != zero);
+            constraints.push_back(!(lhs == signedMin && rhs == ~zero));
+            return binOp->getOpcode() == Instruction::SDiv ? lhs / rhs : srem(lhs, rhs);
+        }
+        case Instruction::UDiv:
+            constraints.push_back(rhs != zero);
+            return udiv(lhs, rhs);
+        case Instruction::URem:
+            constraints.push_back(rhs != zero);
+            return urem(lhs, rhs);
+        case Instruction::And:
+            return lhs & rhs;
+        case Instruction::Or:
+            return lhs | rhs;
+        case Instruction::Xor:
+            return lhs ^ rhs;
+        case Instruction::Shl:
+        case Instruction::LShr:
+        case Instruction::AShr: {
+            // Shifting by the width or more yields poison
+            constraints.push_back(ult(rhs, ctx.bv_val(width, width)));
+            if (binOp->getOpcode() == Instruction::Shl) {
+                return shl(lhs, rhs);
+            }
+            return binOp->getOpcode() == Instruction::LShr ? lshr(lhs, rhs) : ashr(lhs, rhs);
+        }
+        default:
+            return freshSymbol(binOp);
+    }
+}
+
+
+expr ConstraintEncoder::encodeICmp(const ICmpInst* icmp, SymbolicState& state) {
+    expr lhs = getValue(icmp->getOperand(0), state);
+    expr rhs = getValue(icmp->getOperand(1), state);
+    if (theory == BitVectorTheory && lhs.is_bv() && rhs.is_bv()) {
+        return encodeBitVectorICmp(icmp, lhs, rhs);
+    }
+
+    // Integer arithmetic has no notion of signedness, so signed and unsigned predicates coincide
+    switch (icmp->getPredicate()) {
+        case CmpInst::ICMP_EQ:
+            return lhs == rhs;
+        case CmpInst::ICMP_NE:
+            return lhs != rhs;
+        case CmpInst::ICMP_UGT:
+        case CmpInst::ICMP_SGT:
+            return lhs > rhs;
+        case CmpInst::ICMP_UGE:
+        case CmpInst::ICMP_SGE:
+            return lhs >= rhs;
+        case CmpInst::ICMP_ULT:
+        case CmpInst::ICMP_SLT:
+            return lhs < rhs;
+        case CmpInst::ICMP_ULE:
+        case CmpInst::ICMP_SLE:
+            return lhs <= rhs;
+        default:
+            return freshSymbol(icmp);
+    }
+}
+
+
+expr ConstraintEncoder::encodeBitVectorICmp(const ICmpInst* icmp, const expr& lhs, const expr& rhs) {
+    // The comparison operators of z3::expr are signed on bitvectors
+    switch (icmp->getPredicate()) {
+        case CmpInst::ICMP_EQ:
+            return lhs == rhs;
+        case CmpInst::ICMP_NE:
+            return lhs != rhs;
+        case CmpInst::ICMP_UGT:
+            return ugt(lhs, rhs);
+        case CmpInst::ICMP_UGE:
+            return uge(lhs, rhs);
+        case CmpInst::ICMP_ULT:
+            return ult(lhs, rhs);
+        case CmpInst::ICMP_ULE:
+            return ule(lhs, rhs);
+        case CmpInst::ICMP_SGT:
+            return lhs > rhs;
+        case CmpInst::ICMP_SGE:
+            return lhs >= rhs;
+        case CmpInst::ICMP_SLT:
+            return lhs < rhs;
+        case CmpInst::ICMP_SLE:
+            return lhs <= rhs;
+        default:
+            return freshSymbol(icmp);
+    }
+}
+
+
+expr ConstraintEncoder::encodeCast(const CastInst* cast, SymbolicState& state) {
+    expr operand = getValue(cast->getOperand(0), state);
+    if (theory == BitVectorTheory && (operand.is_bv() || operand.is_bool())) {
+        return encodeBitVectorCast(cast, operand);
+    }
+
+    switch (cast->getOpcode()) {
+        case Instruction::ZExt:
+            if (operand.is_bool()) {
+                return ite(operand, ctx.int_val(1), ctx.int_val(0));
+            }
+            return operand;
+        case Instruction::SExt:
+            if (operand.is_bool()) {
+                return ite(operand, ctx.int_val(-1), ctx.int_val(0));
+            }
+            return operand;
+        case Instruction::Trunc:
+            if (cast->getType()->isIntegerTy(1)) {
+                return mod(operand, 2) == 1;
+            }
+            return operand;
+        default:
+            return freshSymbol(cast);
+    }
+}
+
+
+expr ConstraintEncoder::encodeBitVectorCast(const CastInst* cast, const expr& operand) {
+    unsigned width = getBitWidth(cast->getType());
+
+    switch (cast->getOpcode()) {
+        case Instruction::ZExt:
+            if (operand.is_bool()) {
+                return ite(operand, ctx.bv_val(1, width), ctx.bv_val(0, width));
+            }
+            return zext(operand, width - operand.get_sort().bv_size());
+        case Instruction::SExt:
+            if (operand.is_bool()) {
+                return ite(operand, ~ctx.bv_val(0, width), ctx.bv_val(0, width));
+            }
+            return sext(operand, width - operand.get_sort().bv_size());
+        case Instruction::Trunc:
+            if (operand.is_bool()) {
+                break;
+            }
+            if (cast->getType()->isIntegerTy(1)) {
+                return operand.extract(0, 0) == ctx.bv_val(1, 1);
+            }
+            return operand.extract(width - 1, 0);
+        default:
+            break;
+    }
+    return freshSymbol(cast);
+}
+
+
+void ConstraintEncoder::mergeStates(const std::vector<SymbolicState>& states, const std::vector<expr>& guards,
+                                    SymbolicState& merged) {
+    merged = SymbolicState();
+    // The paths meet at one node, after the phis of its block, so later phis do not read incoming_block. No path
+    // calls a function either, so the regions were written by calls the same number of times on each
+    merged.current_block = states.front().current_block;
+    merged.incoming_block = states.front().incoming_block;
+    merged.region_epochs = states.front().region_epochs;
+
+    std::vector<expr> alternatives;
+    size_t numValues = 0;
+    size_t numCells = 0;
+    size_t numArrays = 0;
+    for (const SymbolicState& state : states) {
+        numValues = std::max(numValues, state.value_slots.size());
+        numCells = std::max(numCells, state.memory_slots.size());
+        numArrays = std::max(numArrays, state.array_slots.size());
+    }
+
+    // A value bound on only some of the paths is either defined inside the region, and then dead past it, or a symbol
+    // every path would create alike, so any binding stands in for the missing ones
+    for (ValueIndex::ValueID id = 0; id < numValues; id++) {
+        alternatives.clear();
+        expr e(ctx);
+        for (const SymbolicState& state : states) {
+            if (state.lookupValue(id, e)) {
+                alternatives.push_back(e);
+            }
+        }
+        if (alternatives.empty()) {
+            continue;
+        }
+        if (alternatives.size() < states.size()) {
+            merged.bindValue(id, alternatives.front());
+            continue;
+        }
+        merged.bindValue(id, selectByGuard(alternatives, guards));
+    }
+
+    for (CellID cell = 0; cell < numCells; cell++) {
+        expr e(ctx);
+        z3::sort valueSort(ctx);
+        bool bound = false;
+        for (const SymbolicState& state : states) {
+            if (state.lookupMemory(cell, e)) {
+                valueSort = e.get_sort();
+                bound = true;
+                break;
+            }
+        }
+        if (!bound) {
+            continue;
+        }
+        alternatives.clear();
+        for (const SymbolicState& state : states) {
+            if (!state.lookupMemory(cell, e) || !z3::eq(e.get_sort(), valueSort)) {
+                e = readUnboundCell(cell, valueSort, state);
+            }
+            alternatives.push_back(e);
+        }
+        merged.bindMemory(cell, selectByGuard(alternatives, guards));
+    }
+
+    for (ArrayID array = 0; array < numArrays; array++) {
+        alternatives.clear();
+        bool bound = false;
+        for (const SymbolicState& state : states) {
+            expr contents(ctx);
+            bound |= state.lookupArray(array, contents);
+            alternatives.push_back(getArrayContents(array, state));
+        }
+        if (bound) {
+            merged.bindArray(array, selectByGuard(alternatives, guards));
+        }
+    }
+}
+
+
+/// ite(guards[0], alternatives[0], ite(guards[1], alternatives[1], ...)), or the common alternative if all are equal
+expr ConstraintEncoder::selectByGuard(const std::vector<expr>& alternatives, const std::vector<expr>& guards) {
+    bool allEqual = true;
+    for (const expr& alternative : alternatives) {
+        allEqual = allEqual && z3::eq(alternative, alternatives.front());
+    }
+    if (allEqual) {
+        return alternatives.front();
+    }
+    expr result = alternatives.back();
+    for (size_t i = alternatives.size() - 1; i-- > 0;) {
+        result = ite(guards[i], alternatives[i], result);
+    }
+    return result;
+}
+
+
+/**
+ * The address a GEP computes: concrete if its base is concrete and its indices constant, the base plus the offset of
+ * every index otherwise.
+ */
+expr ConstraintEncoder::encodeGEP(const GEPOperator* gep, SymbolicState& state) {
+    expr base = getValue(gep->getPointerOperand(), state);
+    if (dataLayout == nullptr || gep->getType()->isVectorTy()) {
+        return freshSymbol(gep);
+    }
+
+    uint64_t baseAddress = 0;
+    APInt constantOffset(POINTER_WIDTH, 0);
+    if (base.is_numeral_u64(baseAddress) && (baseAddress >> OBJECT_SHIFT) > 0
+            && gep->accumulateConstantOffset(*dataLayout, constantOffset)) {
+        int64_t offset = (int64_t) (baseAddress & ((1ULL << OBJECT_SHIFT) - 1)) + constantOffset.getSExtValue();
+        if (offset >= 0 && offset < (1LL << OBJECT_SHIFT)) {
+            return makeAddress((baseAddress >> OBJECT_SHIFT) - 1, offset);
+        }
+    }
+
+    expr address = base;
+    for (gep_type_iterator it = gep_type_begin(gep); it != gep_type_end(gep); ++it) {
+        if (StructType* structType = it.getStructTypeOrNull()) {
+            uint64_t field = SVFUtil::cast<ConstantInt>(it.getOperand())->getZExtValue();
+            uint64_t fieldOffset = dataLayout->getStructLayout(structType)->getElementOffset(field);
+            if (fieldOffset > 0) {
+                address = address + makeOffset(fieldOffset);
+            }
+            continue;
+        }
+        const ConstantInt* constantIndex = SVFUtil::dyn_cast<ConstantInt>(it.getOperand());
+        if (constantIndex != nullptr && constantIndex->isZero()) {
+            continue;
+        }
+        int64_t size = dataLayout->getTypeAllocSize(it.getIndexedType()).getFixedSize();
+        expr index = getValue(it.getOperand(), state);
+        if (index.is_bool()) {
+            return freshSymbol(gep);
+        }
+        if (index.is_bv() && index.get_sort().bv_size() < POINTER_WIDTH) {
+            index = sext(index, POINTER_WIDTH - index.get_sort().bv_size());
+        }
+        address = address + index * makeOffset(size);
+    }
+    return address;
+}
+
+
+/// Stores value at a concrete address into its cell, through a symbolic pointer into the array of ptr's region
+void ConstraintEncoder::storeMemory(const Value* ptr, const expr& value, SymbolicState& state) {
+    expr address = getValue(ptr, state);
+    CellID cell;
+    if (getCell(address, cell)) {
+        state.bindMemory(cell, value);
+        return;
+    }
+    MemoryRegions::RegionID region = regions.getRegion(ptr);
+    flushRegion(region, state);
+    ArrayID array = getArray(region, value.get_sort());
+    state.bindArray(array, z3::store(getArrayContents(array, state), address, value));
+}
+
+
+/**
+ * Reads a concrete address from its cell, or from the array of its region once the region was accessed through a
+ * symbolic pointer or written by a call. Reading a cell nothing was stored to yields a symbol named after the cell.
+ */
+expr ConstraintEncoder::loadMemory(const LoadInst* load, SymbolicState& state) {
+    z3::sort valueSort = getSort(load->getType());
+    expr address = getValue(load->getPointerOperand(), state);
+    expr e(ctx);
+    CellID cell;
+    if (getCell(address, cell)) {
+        if (state.lookupMemory(cell, e) && z3::eq(e.get_sort(), valueSort)) {
+            return e;
+        }
+        // Reading the cell again must give the same symbol; reads from the array of its region always do
+        e = readUnboundCell(cell, valueSort, state);
+        if (e.is_const()) {
+            state.bindMemory(cell, e);
+        }
+        return e;
+    }
+
+    MemoryRegions::RegionID region = regions.getRegion(load->getPointerOperand());
+    flushRegion(region, state);
+    ArrayID array = getArray(region, valueSort);
+    expr contents = getArrayContents(array, state);
+    // Later reads of cells in the region go through the array as well, so they agree with this one
+    state.bindArray(array, contents);
+    return select(contents, address);
+}
+
+
+/// Moves the cells of region into its arrays, ahead of an access through a symbolic pointer that may hit any of them
+void ConstraintEncoder::flushRegion(MemoryRegions::RegionID region, SymbolicState& state) {
+    expr value(ctx);
+    for (CellID cell = 0; cell < state.memory_slots.size(); cell++) {
+        if (cells[cell].region != region || !state.lookupMemory(cell, value)) {
+            continue;
+        }
+        ArrayID array = getArray(region, value.get_sort());
+        state.bindArray(array, z3::store(getArrayContents(array, state), getCellAddress(cell), value));
+        state.unbindMemory(cell);
+    }
+}
+
+
+/// Forgets the contents of region; reads then go to fresh arrays named after the number of times this happened
+void ConstraintEncoder::havocRegion(MemoryRegions::RegionID region, SymbolicState& state) {
+    for (CellID cell = 0; cell < state.memory_slots.size(); cell++) {
+        if (cells[cell].region == region) {
+            state.unbindMemory(cell);
+        }
+    }
+    for (ArrayID array = 0; array < state.array_slots.size(); array++) {
+        if (arrays[array].region == region) {
+            state.unbindArray(array);
+        }
+    }
+    state.advanceEpoch(region);
+}
+
+
+/**
+ * Contents of a cell nothing was stored to since its region was last flushed or written by a call: a read from the
+ * array of its region once there is one, a symbol named after the cell otherwise.
+ */
+expr ConstraintEncoder::readUnboundCell(CellID cell, const z3::sort& valueSort, const SymbolicState& state) {
+    MemoryRegions::RegionID region = cells[cell].region;
+    ArrayID array = getArray(region, valueSort);
+    expr contents(ctx);
+    if (state.lookupArray(array, contents) || state.getEpoch(region) > 0) {
+        return select(getArrayContents(array, state), getCellAddress(cell));
+    }
+    return ctx.constant(cells[cell].name.c_str(), valueSort);
+}
+
+
+/// Sets cell to the cell of a concrete address and returns true, or returns false if address is symbolic
+bool ConstraintEncoder::getCell(const expr& address, CellID& cell) {
+    uint64_t value = 0;
+    if (!address.is_numeral_u64(value)) {
+        return false;
+    }
+    uint64_t object = value >> OBJECT_SHIFT;
+    if (object == 0 || object > regions.getNumObjects()) {
+        return false;
+    }
+    auto it = cellIds.insert(std::make_pair(value, (CellID) cells.size()));
+    if (it.second) {
+        uint64_t offset = value & ((1ULL << OBJECT_SHIFT) - 1);
+        std::string name = getSymbolName(regions.getObject(object - 1));
+        if (offset > 0) {
+            name += "+" + std::to_string(offset);
+        }
+        cells.push_back(Cell{value, regions.getObjectRegion(object - 1), name});
+    }
+    cell = it.first->second;
+    return true;
+}
+
+
+ConstraintEncoder::ArrayID ConstraintEncoder::getArray(MemoryRegions::RegionID region, const z3::sort& valueSort) {
+    // Values are booleans, integers or bitvectors of up to a few thousand bits
+    uint64_t sortKey = valueSort.is_bool() ? 0 : valueSort.is_int() ? 1 : 2 + valueSort.bv_size();
+    auto it = arrayIds.insert(std::make_pair(((uint64_t) region << 32) | sortKey, (ArrayID) arrays.size()));
+    if (it.second) {
+        std::string sortName = valueSort.is_bool() ? "b" : valueSort.is_int() ? "i"
+                             : "bv" + std::to_string(valueSort.bv_size());
+        arrays.push_back(MemoryArray{region, valueSort, "@mem" + std::to_string(region) + "_" + sortName});
+    }
+    return it.first->second;
+}
+
+
+/// The array region contents of one sort are held in; unconstrained until the region is stored to
+expr ConstraintEncoder::getArrayContents(ArrayID array, const SymbolicState& state) {
+    expr contents(ctx);
+    if (state.lookupArray(array, contents)) {
+        return contents;
+    }
+    const MemoryArray& memoryArray = arrays[array];
+    std::string name = memoryArray.name;
+    if (unsigned epoch = state.getEpoch(memoryArray.region)) {
+        name += "." + std::to_string(epoch);
+    }
+    z3::sort addressSort = theory == IntegerTheory ? ctx.int_sort() : ctx.bv_sort(POINTER_WIDTH);
+    return ctx.constant(name.c_str(), ctx.array_sort(addressSort, memoryArray.valueSort));
+}
+
+
+expr ConstraintEncoder::getCellAddress(CellID cell) {
+    return theory == IntegerTheory ? ctx.int_val((int64_t) cells[cell].address)
+                                   : ctx.bv_val(cells[cell].address, POINTER_WIDTH);
+}
+
+
+expr ConstraintEncoder::makeAddress(MemoryRegions::ObjectID object, uint64_t offset) {
+    uint64_t address = ((uint64_t) object + 1) << OBJECT_SHIFT | offset;
+    return theory == IntegerTheory ? ctx.int_val((int64_t) address) : ctx.bv_val(address, POINTER_WIDTH);
+}
+
+
+expr ConstraintEncoder::makeOffset(int64_t offset) {
+    return theory == IntegerTheory ? ctx.int_val(offset) : ctx.bv_val((uint64_t) offset, POINTER_WIDTH);
+}
+
+
+expr ConstraintEncoder::freshSymbol(const Value* v) {
+    return makeSymbol(v, "");
+}
+
+
+expr ConstraintEncoder::toBool(const expr& e) {
+    if (e.is_bool()) {
+        return e;
+    }
+    return e != 0;
+}
+
+
+z3::sort ConstraintEncoder::getSort(const Type* type) {
+    if (type->isIntegerTy(1)) {
+        return ctx.bool_sort();
+    }
+    if (theory == BitVectorTheory) {
+        return ctx.bv_sort(getBitWidth(type));
+    }
+    return ctx.int_sort();
+}
+
+
+unsigned ConstraintEncoder::getBitWidth(const Type* type) const {
+    if (type->isIntegerTy()) {
+        return type->getIntegerBitWidth();
+    }
+    return POINTER_WIDTH;
+}
+
+
+const std::string& ConstraintEncoder::getSymbolName(const Value* v) {
+    auto it = symbolNames.find(v);
+    if (it != symbolNames.end()) {
+        return it->second;
+    }
+
+    std::string name;
+    if (v->hasName()) {
+        name = "%" + v->getName().str();
+    } else {
+        // Unnamed temporaries get the slot number LLVM prints for them (e.g. %0). Printing builds a slot tracker over
+        // the shared module, so encoders running in different threads take turns
+        static std::mutex printMutex;
+        std::lock_guard<std::mutex> lock(printMutex);
+        raw_string_ostream os(name);
+        v->printAsOperand(os, false);
+        os.flush();
+    }
+    return symbolNames.emplace(v, name).first->second;
+}
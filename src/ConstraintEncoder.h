@@ -0,0 +1,160 @@
+//===- ConstraintEncoder.h -- Z3 encoding of ICFG nodes and edges -----------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+/*
+ * Translates the LLVM instructions held by ICFG nodes into Z3 expressions by reading their opcodes, predicates and
+ * operands directly, so no node is ever printed or re-parsed while a path is explored.
+ *
+ * Integers are encoded either as unbounded integers, which cannot tell signed from unsigned operations and never
+ * overflow, or as bitvectors of their LLVM width (pointers are 64 bits wide), which are exact.
+ *
+ * Every alloca and global has a concrete address, the object ID in the upper 32 bits and the offset in the lower ones,
+ * and GEPs with constant indices off a concrete address stay concrete. Loads and stores at concrete addresses read and
+ * write single cells without involving the solver. Accesses through symbolic pointers select from and store into one
+ * Z3 array per memory region and value sort, so they only ever meet the stores of their own region.
+ */
+
+#ifndef CONSTRAINTENCODER_H_
+#define CONSTRAINTENCODER_H_
+
+#include "Graphs/ICFG.h"
+#include "MemoryRegions.h"
+#include "SymbolicState.h"
+#include "llvm/IR/DataLayout.h"
+#include "llvm/IR/Operator.h"
+#include <z3++.h>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class ConstraintEncoder {
+public:
+    typedef std::vector<z3::expr> ConstraintList;
+
+    enum Theory {
+        IntegerTheory,
+        BitVectorTheory
+    };
+
+    ConstraintEncoder(z3::context& c, const MemoryRegions& regions, Theory theory = IntegerTheory)
+        : ctx(c), theory(theory), regions(regions), dataLayout(nullptr) {}
+
+    /// Steps into node, updating state and appending the constraints the node contributes
+    void encodeNode(const SVF::ICFGNode* node, SymbolicState& state, ConstraintList& constraints);
+
+    /**
+     * Takes edge, recording the block it leaves for the phis of the block it enters.
+     *
+     * @return  True if taking edge constrains the path, with cond set to its condition
+     */
+    bool encodeEdge(const SVF::ICFGEdge* edge, SymbolicState& state, z3::expr& cond);
+
+    /// Expression currently bound to v, creating a fresh symbol for values the encoder does not model
+    z3::expr getValue(const llvm::Value* v, SymbolicState& state);
+
+    void bindValue(const llvm::Value* v, const z3::expr& e, SymbolicState& state);
+
+    /// Symbol named after v with suffix appended, for values defined more than once on a path
+    z3::expr makeSymbol(const llvm::Value* v, const std::string& suffix);
+
+    /// Symbol of the sort values of type are encoded with
+    z3::expr makeSymbol(const std::string& name, const llvm::Type* type);
+
+    /// Forgets what was stored to the memory a call may write: the regions reachable from its pointer arguments and
+    /// the regions holding globals
+    void havocMemory(const llvm::CallBase* call, SymbolicState& state);
+
+    /**
+     * Combines the states of alternative paths meeting at the same node. Values, cells and arrays the paths disagree on
+     * become ite expressions selecting the binding of the first path whose guard holds.
+     *
+     * @param guards  Condition of the path to each state; the last one is implied by the others not holding
+     */
+    void mergeStates(const std::vector<SymbolicState>& states, const std::vector<z3::expr>& guards,
+                     SymbolicState& merged);
+
+    z3::context& getContext() {
+        return ctx;
+    }
+
+private:
+    void encodeInstruction(const llvm::Instruction* inst, SymbolicState& state, ConstraintList& constraints);
+    z3::expr encodeBinaryOperator(const llvm::BinaryOperator* binOp, SymbolicState& state, ConstraintList& constraints);
+    z3::expr encodeICmp(const llvm::ICmpInst* icmp, SymbolicState& state);
+    z3::expr encodeCast(const llvm::CastInst* cast, SymbolicState& state);
+
+    z3::expr encodeBitVectorOperator(const llvm::BinaryOperator* binOp, const z3::expr& lhs, const z3::expr& rhs,
+                                     ConstraintList& constraints);
+    z3::expr encodeBitVectorICmp(const llvm::ICmpInst* icmp, const z3::expr& lhs, const z3::expr& rhs);
+    z3::expr encodeBitVectorCast(const llvm::CastInst* cast, const z3::expr& operand);
+
+    typedef unsigned CellID;
+    typedef unsigned ArrayID;
+
+    /// Memory at a concrete address
+    struct Cell {
+        uint64_t address;
+        MemoryRegions::RegionID region;
+        std::string name;  ///< Of the symbol read from the cell before anything was stored to it
+    };
+
+    /// Contents of a memory region for values of one sort
+    struct MemoryArray {
+        MemoryRegions::RegionID region;
+        z3::sort valueSort;
+        std::string name;
+    };
+
+    z3::expr encodeGEP(const llvm::GEPOperator* gep, SymbolicState& state);
+    void storeMemory(const llvm::Value* ptr, const z3::expr& value, SymbolicState& state);
+    z3::expr loadMemory(const llvm::LoadInst* load, SymbolicState& state);
+    void flushRegion(MemoryRegions::RegionID region, SymbolicState& state);
+    void havocRegion(MemoryRegions::RegionID region, SymbolicState& state);
+    z3::expr readUnboundCell(CellID cell, const z3::sort& valueSort, const SymbolicState& state);
+    bool getCell(const z3::expr& address, CellID& cell);
+    ArrayID getArray(MemoryRegions::RegionID region, const z3::sort& valueSort);
+    z3::expr getArrayContents(ArrayID array, const SymbolicState& state);
+    z3::expr selectByGuard(const std::vector<z3::expr>& alternatives, const std::vector<z3::expr>& guards);
+    z3::expr getCellAddress(CellID cell);
+    z3::expr makeAddress(MemoryRegions::ObjectID object, uint64_t offset);
+    z3::expr makeOffset(int64_t offset);
+
+    z3::expr freshSymbol(const llvm::Value* v);
+    z3::expr toBool(const z3::expr& e);
+    z3::sort getSort(const llvm::Type* type);
+    unsigned getBitWidth(const llvm::Type* type) const;
+    const std::string& getSymbolName(const llvm::Value* v);
+
+    z3::context& ctx;
+    Theory theory;
+    ValueIndex valueIndex;
+    std::unordered_map<const llvm::Value*, std::string> symbolNames;  ///< Names are only formatted once per value
+    const MemoryRegions& regions;
+    const llvm::DataLayout* dataLayout;  ///< Of the module encoded, known once the first instruction is encoded
+    std::vector<Cell> cells;
+    std::unordered_map<uint64_t, CellID> cellIds;  ///< By address
+    std::vector<MemoryArray> arrays;
+    std::unordered_map<uint64_t, ArrayID> arrayIds;  ///< By region and sort
+};
+
+#endif /* CONSTRAINTENCODER_H_ */
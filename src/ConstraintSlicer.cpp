@@ -0,0 +1,142 @@
+//===- ConstraintSlicer.cpp -- Independence slicing of path constraints -----//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+#include "ConstraintSlicer.h"
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace z3;
+
+
+SlicedConstraint::SlicedConstraint(const expr& constraint, bool collectSymbols)
+    : constraint(constraint), simplified(constraint.simplify()) {
+    if (!collectSymbols) {
+        return;
+    }
+    std::unordered_set<unsigned> visited;
+    std::vector<expr> worklist(1, simplified);
+    while (!worklist.empty()) {
+        expr e = worklist.back();
+        worklist.pop_back();
+        if (!visited.insert(e.id()).second || !e.is_app()) {
+            continue;
+        }
+        if (e.num_args() == 0 && e.decl().decl_kind() == Z3_OP_UNINTERPRETED) {
+            symbols.push_back(e.id());
+        }
+        for (unsigned i = 0; i < e.num_args(); i++) {
+            worklist.push_back(e.arg(i));
+        }
+    }
+}
+
+
+unsigned ConstraintSlicer::find(unsigned i) const {
+    while (parent[i] != i) {
+        i = parent[i];
+    }
+    return i;
+}
+
+
+void ConstraintSlicer::add(const SlicedConstraint& constraint) {
+    unsigned i = parent.size();
+    parent.push_back(i);
+    members.push_back(Cluster(1, i));
+    trivial.push_back(constraint.isTrivial());
+    changeMarks.push_back(changes.size());
+    if (constraint.isTrivial()) {
+        return;
+    }
+
+    // The constraint is merged with the first constraint mentioning each of its symbols, the smaller cluster into the
+    // larger one, which keeps every find() logarithmic without path compression
+    for (unsigned symbol : constraint.symbols) {
+        auto it = firstUse.insert(std::make_pair(symbol, i));
+        if (it.second) {
+            changes.push_back(Change{false, symbol, 0, 0});
+            continue;
+        }
+        unsigned root = find(it.first->second);
+        unsigned self = find(i);
+        if (root == self) {
+            continue;
+        }
+        if (members[root].size() < members[self].size()) {
+            std::swap(root, self);
+        }
+        parent[self] = root;
+        members[root].insert(members[root].end(), members[self].begin(), members[self].end());
+        changes.push_back(Change{true, 0, self, root});
+    }
+}
+
+
+void ConstraintSlicer::truncate(unsigned size) {
+    if (size >= parent.size()) {
+        return;
+    }
+    while (changes.size() > changeMarks[size]) {
+        const Change& change = changes.back();
+        if (change.isMerge) {
+            // The child kept its own members, which were appended last to those of the root
+            members[change.root].resize(members[change.root].size() - members[change.child].size());
+            parent[change.child] = change.child;
+        } else {
+            firstUse.erase(change.symbol);
+        }
+        changes.pop_back();
+    }
+    parent.resize(size);
+    members.resize(size);
+    trivial.resize(size);
+    changeMarks.resize(size);
+}
+
+
+std::vector<ConstraintSlicer::Cluster> ConstraintSlicer::partition() const {
+    std::vector<Cluster> clusters;
+    std::vector<bool> listed(parent.size(), false);
+    for (unsigned i = 0; i < parent.size(); i++) {
+        if (trivial[i]) {
+            continue;
+        }
+        unsigned root = find(i);
+        if (!listed[root]) {
+            listed[root] = true;
+            clusters.push_back(members[root]);
+            std::sort(clusters.back().begin(), clusters.back().end());
+        }
+    }
+    return clusters;
+}
+
+
+ConstraintSlicer::Cluster ConstraintSlicer::slice(unsigned seed) const {
+    if (trivial[seed]) {
+        return Cluster();
+    }
+    Cluster cluster = members[find(seed)];
+    std::sort(cluster.begin(), cluster.end());
+    return cluster;
+}
@@ -0,0 +1,94 @@
+//===- ConstraintSlicer.h -- Independence slicing of path constraints -------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+/*
+ * Constraints that share no symbol, directly or through other constraints, can be solved separately: their conjunction
+ * is satisfiable iff every cluster is, and the models of the clusters combine into a model of the conjunction. When a
+ * branch condition is added to a prefix already known to be satisfiable, only its own cluster needs to be checked.
+ *
+ * The clusters are kept up to date as constraints are added to the path and removed again when it backtracks, so
+ * slicing at a branch costs as much as the cluster of the branch, not as the path.
+ */
+
+#ifndef CONSTRAINTSLICER_H_
+#define CONSTRAINTSLICER_H_
+
+#include <z3++.h>
+#include <unordered_map>
+#include <vector>
+
+/// A path constraint together with its simplified form and the symbols the simplified form mentions
+struct SlicedConstraint {
+    z3::expr constraint;            ///< Constraint as encoded, which is what reports print
+    z3::expr simplified;            ///< Constraint after constant propagation and rewriting, which is what is solved
+    std::vector<unsigned> symbols;  ///< AST ids of the uninterpreted constants of simplified
+
+    /// @param collectSymbols  Whether the constraint will be sliced, otherwise symbols is left empty
+    SlicedConstraint(const z3::expr& constraint, bool collectSymbols);
+
+    /// Simplified to true, so it never needs to be solved
+    bool isTrivial() const {
+        return simplified.is_true();
+    }
+};
+
+
+class ConstraintSlicer {
+public:
+    typedef std::vector<unsigned> Cluster;  ///< Indices of constraints, ascending
+
+    /// Adds the constraint numbered size(), merging the clusters of the earlier constraints sharing a symbol with it
+    void add(const SlicedConstraint& constraint);
+
+    /// Removes the constraints from the size-th one on, undoing the merges they caused
+    void truncate(unsigned size);
+
+    unsigned size() const {
+        return parent.size();
+    }
+
+    /// Splits the non-trivial constraints into independent clusters, ordered by their first constraint
+    std::vector<Cluster> partition() const;
+
+    /// The cluster of constraints depending on constraint seed, empty if that constraint is trivial
+    Cluster slice(unsigned seed) const;
+
+private:
+    /// Either a symbol first used by the constraint being added, or the merge of the cluster of child into root
+    struct Change {
+        bool isMerge;
+        unsigned symbol;
+        unsigned child;
+        unsigned root;
+    };
+
+    unsigned find(unsigned i) const;
+
+    std::vector<unsigned> parent;   ///< Union-find parent, not compressed so merges can be undone
+    std::vector<Cluster> members;   ///< Constraints of the cluster of every root, in no particular order
+    std::vector<bool> trivial;
+    std::unordered_map<unsigned, unsigned> firstUse;  ///< Symbol -> first constraint mentioning it
+    std::vector<Change> changes;    ///< Undo log of add()
+    std::vector<unsigned> changeMarks;  ///< Size of changes before each constraint was added
+};
+
+#endif /* CONSTRAINTSLICER_H_ */
@@ -0,0 +1,60 @@
+//===- DistanceMap.cpp -- ICFG distances to the targets of an exploration ---//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+#include "DistanceMap.h"
+#include <deque>
+
+using namespace SVF;
+
+
+/// Breadth-first search backwards from all targets at once
+DistanceMap::DistanceMap(const std::vector<const ICFGNode*>& targets) {
+    std::deque<const ICFGNode*> worklist;
+    for (const ICFGNode* target : targets) {
+        if (distances.insert(std::make_pair(target, 0)).second) {
+            worklist.push_back(target);
+        }
+    }
+
+    std::vector<const ICFGNode*> predecessors;
+    while (!worklist.empty()) {
+        const ICFGNode* node = worklist.front();
+        worklist.pop_front();
+        unsigned distance = distances[node] + 1;
+
+        predecessors.clear();
+        // Calls are stepped over through the callee summary, never into the callee
+        if (const RetBlockNode* retNode = SVFUtil::dyn_cast<RetBlockNode>(node)) {
+            predecessors.push_back(retNode->getCallBlockNode());
+        }
+        for (const ICFGEdge* edge : node->getInEdges()) {
+            if (!edge->isCallCFGEdge() && !edge->isRetCFGEdge()) {
+                predecessors.push_back(edge->getSrcNode());
+            }
+        }
+        for (const ICFGNode* predecessor : predecessors) {
+            if (distances.insert(std::make_pair(predecessor, distance)).second) {
+                worklist.push_back(predecessor);
+            }
+        }
+    }
+}
@@ -0,0 +1,55 @@
+//===- DistanceMap.h -- ICFG distances to the targets of an exploration -----//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+#ifndef DISTANCEMAP_H_
+#define DISTANCEMAP_H_
+
+#include "Graphs/ICFG.h"
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Number of steps from every node to the nearest target, following the ICFG backwards the way the explorer moves
+ * forwards: along intra-procedural edges, and from a call straight to its return node. Nodes missing from the map
+ * cannot reach any target.
+ */
+class DistanceMap {
+public:
+    static const unsigned Unreachable = ~0u;
+
+    explicit DistanceMap(const std::vector<const SVF::ICFGNode*>& targets);
+
+    /// Steps from node to the nearest target, or Unreachable
+    unsigned getDistance(const SVF::ICFGNode* node) const {
+        auto it = distances.find(node);
+        return it == distances.end() ? Unreachable : it->second;
+    }
+
+    bool canReach(const SVF::ICFGNode* node) const {
+        return distances.find(node) != distances.end();
+    }
+
+private:
+    std::unordered_map<const SVF::ICFGNode*, unsigned> distances;
+};
+
+#endif /* DISTANCEMAP_H_ */
@@ -0,0 +1,123 @@
+//===- ExploredGraph.cpp -- Subgraph of the ICFG covered by an exploration --//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+#include "ExploredGraph.h"
+#include <fstream>
+
+using namespace SVF;
+using namespace std;
+
+namespace {
+
+/// Escapes text for a left-justified dot label
+string escapeLabel(const string& text) {
+    string escaped;
+    for (char c : text) {
+        switch (c) {
+            case '"':
+            case '\\':
+            case '{':
+            case '}':
+            case '<':
+            case '>':
+            case '|':
+                escaped += '\\';
+                escaped += c;
+                break;
+            case '\n':
+                escaped += "\\l";
+                break;
+            default:
+                escaped += c;
+                break;
+        }
+    }
+    return escaped;
+}
+
+
+/// Whether the edge from src to dst steps over a call through the callee's summary
+bool isSummaryEdge(const ICFGNode* src, const ICFGNode* dst) {
+    const RetBlockNode* retNode = SVFUtil::dyn_cast<RetBlockNode>(dst);
+    return retNode != nullptr && retNode->getCallBlockNode() == src;
+}
+
+
+/// Whether the edge from src to dst steps over a merged region from its branch to its join point
+bool isMergedEdge(const ICFGNode* src, const ICFGNode* dst) {
+    for (const ICFGEdge* edge : src->getOutEdges()) {
+        if (edge->getDstNode() == dst) {
+            return false;
+        }
+    }
+    return !isSummaryEdge(src, dst);
+}
+
+} // End anonymous namespace
+
+
+void ExploredGraph::addPath(EdgeSet& edges, const std::vector<NodeID>& path) {
+    for (unsigned i = 1; i < path.size(); i++) {
+        edges.insert(Edge(path[i - 1], path[i]));
+    }
+}
+
+
+void ExploredGraph::merge(const EdgeSet& workerEdges) {
+    lock_guard<mutex> lock(edgesMutex);
+    edges.insert(workerEdges.begin(), workerEdges.end());
+}
+
+
+bool ExploredGraph::write(ICFG* icfg, const string& file) const {
+    ofstream out(file);
+    if (!out) {
+        return false;
+    }
+
+    lock_guard<mutex> lock(edgesMutex);
+    set<NodeID> nodes;
+    for (const Edge& edge : edges) {
+        nodes.insert(edge.first);
+        nodes.insert(edge.second);
+    }
+
+    out << "digraph \"" << (scope == FeasiblePaths ? "Feasible ICFG" : "Explored ICFG") << "\" {\n";
+    out << "\tlabel=\"" << (scope == FeasiblePaths ? "Feasible ICFG" : "Explored ICFG") << "\";\n\n";
+    for (NodeID id : nodes) {
+        out << "\tNode" << id << " [shape=record,label=\"{" << escapeLabel(icfg->getICFGNode(id)->toString())
+            << "\\l}\"];\n";
+    }
+    for (const Edge& edge : edges) {
+        out << "\tNode" << edge.first << " -> Node" << edge.second;
+        const ICFGNode* src = icfg->getICFGNode(edge.first);
+        const ICFGNode* dst = icfg->getICFGNode(edge.second);
+        if (isSummaryEdge(src, dst)) {
+            out << " [style=dashed,label=\"summary\"]";
+        } else if (isMergedEdge(src, dst)) {
+            out << " [style=dashed,label=\"merged\"]";
+        }
+        out << ";\n";
+    }
+    out << "}\n";
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,73 @@
+//===- ExploredGraph.h -- Subgraph of the ICFG covered by an exploration ----//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+#ifndef EXPLOREDGRAPH_H_
+#define EXPLOREDGRAPH_H_
+
+#include "Graphs/ICFG.h"
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Collects the ICFG edges stepped along during exploration, or only those on feasible paths, and writes them as a dot
+ * graph. Unlike ICFG::dump() its size follows what was analyzed rather than the whole module.
+ */
+class ExploredGraph {
+public:
+    enum Scope {
+        ExploredEdges,  ///< Every edge a worker stepped along
+        FeasiblePaths   ///< Only the edges of paths found satisfiable
+    };
+
+    typedef std::pair<SVF::NodeID, SVF::NodeID> Edge;
+    typedef std::set<Edge> EdgeSet;
+
+    explicit ExploredGraph(Scope scope) : scope(scope) {}
+
+    Scope getScope() const {
+        return scope;
+    }
+
+    /// Adds the edges between consecutive nodes of path
+    static void addPath(EdgeSet& edges, const std::vector<SVF::NodeID>& path);
+
+    /// Thread safe
+    void merge(const EdgeSet& workerEdges);
+
+    /**
+     * Writes the collected edges and their nodes. An edge from a call node to its return node, which stands for the
+     * summary of the callee, is drawn dashed.
+     *
+     * @return  False if file could not be written
+     */
+    bool write(SVF::ICFG* icfg, const std::string& file) const;
+
+private:
+    Scope scope;
+    mutable std::mutex edgesMutex;
+    EdgeSet edges;
+};
+
+#endif /* EXPLOREDGRAPH_H_ */
@@ -0,0 +1,477 @@
+//===- FunctionResultCache.cpp -- Results of whole functions across runs ----//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+#include "FunctionResultCache.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+
+using namespace SVF;
+using namespace llvm;
+using namespace std;
+
+/// First line of a cache file; bump the version whenever the hashing or the layout changes
+static const string CACHE_FILE_HEADER = "svf-ex-function-results 1";
+
+namespace {
+
+const uint64_t FNV_OFFSET = 14695981039346656037ULL;
+const uint64_t FNV_PRIME = 1099511628211ULL;
+
+void hashByte(uint64_t& hash, unsigned char byte) {
+    hash ^= byte;
+    hash *= FNV_PRIME;
+}
+
+
+void hashString(uint64_t& hash, const string& text) {
+    for (unsigned char c : text) {
+        hashByte(hash, c);
+    }
+    // Separates consecutive strings, so moving characters from one to the next changes the hash
+    hashByte(hash, 0);
+}
+
+
+void hashNumber(uint64_t& hash, uint64_t value) {
+    for (unsigned i = 0; i < 8; i++) {
+        hashByte(hash, (unsigned char) (value >> (8 * i)));
+    }
+}
+
+
+/// Escapes the characters the cache file uses as separators
+string escape(const string& text) {
+    string escaped;
+    escaped.reserve(text.size());
+    for (char c : text) {
+        switch (c) {
+            case '\\':
+                escaped += "\\\\";
+                break;
+            case '\t':
+                escaped += "\\t";
+                break;
+            case '\n':
+                escaped += "\\n";
+                break;
+            case '\r':
+                escaped += "\\r";
+                break;
+            default:
+                escaped += c;
+                break;
+        }
+    }
+    return escaped;
+}
+
+
+string unescape(const string& text) {
+    string unescaped;
+    unescaped.reserve(text.size());
+    for (size_t i = 0; i < text.size(); i++) {
+        if (text[i] != '\\' || i + 1 == text.size()) {
+            unescaped += text[i];
+            continue;
+        }
+        switch (text[++i]) {
+            case 't':
+                unescaped += '\t';
+                break;
+            case 'n':
+                unescaped += '\n';
+                break;
+            case 'r':
+                unescaped += '\r';
+                break;
+            default:
+                unescaped += text[i];
+                break;
+        }
+    }
+    return unescaped;
+}
+
+
+vector<string> splitFields(const string& line) {
+    vector<string> fields;
+    size_t start = 0;
+    for (size_t tab = line.find('\t'); tab != string::npos; tab = line.find('\t', start)) {
+        fields.push_back(line.substr(start, tab - start));
+        start = tab + 1;
+    }
+    fields.push_back(line.substr(start));
+    return fields;
+}
+
+
+template<typename T>
+void writeNumbers(ostream& out, const vector<T>& numbers) {
+    for (size_t i = 0; i < numbers.size(); i++) {
+        out << (i > 0 ? " " : "") << numbers[i];
+    }
+}
+
+
+template<typename T>
+bool readNumbers(const string& field, vector<T>& numbers) {
+    istringstream in(field);
+    T number;
+    while (in >> number) {
+        numbers.push_back(number);
+    }
+    return in.eof();
+}
+
+} // End anonymous namespace
+
+
+/**
+ * Numbers the nodes of every function with a body by their position: 0 for the entry, 1 for the exit, and three keys
+ * per instruction, for the instruction itself and for the call and return nodes of a call.
+ */
+FunctionResultCache::FunctionResultCache(ICFG* icfg, const MemoryRegions& regions, uint64_t optionsHash)
+    : regions(regions), optionsHash(optionsHash) {
+    std::unordered_map<const Instruction*, uint32_t> positions;
+    for (ICFG::iterator it = icfg->begin(); it != icfg->end(); ++it) {
+        const ICFGNode* node = it->second;
+        if (node->getFun() == nullptr || node->getFun()->isDeclaration()) {
+            continue;
+        }
+        const Function* fun = node->getFun()->getLLVMFun();
+        if (functionNames.insert(node->getFun()->getName()).second) {
+            uint32_t position = 0;
+            for (const Instruction& inst : instructions(fun)) {
+                positions[&inst] = position++;
+            }
+        }
+
+        uint32_t key;
+        if (SVFUtil::isa<FunEntryBlockNode>(node)) {
+            key = 0;
+        } else if (SVFUtil::isa<FunExitBlockNode>(node)) {
+            key = 1;
+        } else if (const IntraBlockNode* intraNode = SVFUtil::dyn_cast<IntraBlockNode>(node)) {
+            key = 2 + 3 * positions[intraNode->getInst()];
+        } else if (const CallBlockNode* callNode = SVFUtil::dyn_cast<CallBlockNode>(node)) {
+            key = 3 + 3 * positions[callNode->getCallSite()];
+            callNodes[fun].push_back(callNode);
+        } else if (const RetBlockNode* retNode = SVFUtil::dyn_cast<RetBlockNode>(node)) {
+            key = 4 + 3 * positions[retNode->getCallSite()];
+        } else {
+            continue;
+        }
+        nodeKeys[node->getId()] = key;
+        nodesByKey[fun][key] = node->getId();
+    }
+}
+
+
+uint64_t FunctionResultCache::hashOptions(const ExplorerOptions& options, bool reportsPaths) {
+    ostringstream text;
+    text << options.pruneInfeasible << options.sliceConstraints << options.pruneUnreachable << options.nearestFirst
+         << options.stopAtWitness << options.mergeStates << reportsPaths << ' ' << options.scheduler << ' '
+         << options.schedulerSeed << ' ' << options.numThreads << ' ' << options.maxLoopUnroll << ' '
+         << options.maxNodeVisits << ' ' << options.maxPathDepth << ' ' << options.maxSummaryPaths << ' '
+         << options.maxMergePaths << ' ' << options.theory << ' ' << options.solverLimits.timeout << ' '
+         << options.solverLimits.rlimit;
+    uint64_t hash = FNV_OFFSET;
+    hashString(hash, text.str());
+    return hash;
+}
+
+
+/**
+ * Combines the hashes of fun and of every function it may reach through calls, in name order, with the regions they
+ * access. The name of fun comes first, so mutually recursive functions still get different hashes.
+ */
+uint64_t FunctionResultCache::getHash(const Function* fun) {
+    auto it = hashes.find(fun);
+    if (it != hashes.end()) {
+        return it->second;
+    }
+
+    std::vector<const Function*> reached(1, fun);
+    std::unordered_set<const Function*> visited(reached.begin(), reached.end());
+    std::vector<const Function*> callees;
+    for (size_t i = 0; i < reached.size(); i++) {
+        callees.clear();
+        getCallees(reached[i], callees);
+        for (const Function* callee : callees) {
+            if (visited.insert(callee).second) {
+                reached.push_back(callee);
+            }
+        }
+    }
+    std::sort(reached.begin(), reached.end(), [](const Function* a, const Function* b) {
+        return a->getName() < b->getName();
+    });
+
+    uint64_t hash = optionsHash;
+    hashString(hash, fun->getName().str());
+    hashString(hash, fun->getParent()->getDataLayoutStr());
+    std::unordered_map<MemoryRegions::RegionID, unsigned> numbering;
+    for (const Function* member : reached) {
+        hashString(hash, member->getName().str());
+        hashNumber(hash, getIRHash(member));
+        hashRegions(member, numbering, hash);
+    }
+    hashRegions(nullptr, numbering, hash);
+    hashes[fun] = hash;
+    return hash;
+}
+
+
+/// FNV-1a hash of the printed IR of fun, without the numbers of metadata nodes and attribute groups
+uint64_t FunctionResultCache::getIRHash(const Function* fun) {
+    auto it = irHashes.find(fun);
+    if (it != irHashes.end()) {
+        return it->second;
+    }
+    string text;
+    raw_string_ostream out(text);
+    fun->print(out);
+    out.flush();
+
+    uint64_t hash = FNV_OFFSET;
+    bool numbered = false;
+    for (char c : text) {
+        if (numbered && isdigit((unsigned char) c)) {
+            continue;
+        }
+        numbered = c == '!' || c == '#';
+        hashByte(hash, c);
+    }
+    irHashes[fun] = hash;
+    return hash;
+}
+
+
+/// Functions with a body the calls of fun may enter, as resolved in the ICFG
+void FunctionResultCache::getCallees(const Function* fun, std::vector<const Function*>& callees) const {
+    auto it = callNodes.find(fun);
+    if (it == callNodes.end()) {
+        return;
+    }
+    for (const CallBlockNode* callNode : it->second) {
+        for (const ICFGEdge* edge : callNode->getOutEdges()) {
+            const FunEntryBlockNode* entry = SVFUtil::dyn_cast<FunEntryBlockNode>(edge->getDstNode());
+            if (edge->isCallCFGEdge() && entry != nullptr && !entry->getFun()->isDeclaration()) {
+                callees.push_back(entry->getFun()->getLLVMFun());
+            }
+        }
+    }
+}
+
+
+/**
+ * Hashes the regions of the loads, stores and pointer arguments of fun in instruction order, or the global regions if
+ * fun is null. Regions are numbered by first access rather than by ID, as IDs shift with the rest of the module.
+ */
+void FunctionResultCache::hashRegions(const Function* fun,
+                                      std::unordered_map<MemoryRegions::RegionID, unsigned>& numbering,
+                                      uint64_t& hash) const {
+    auto hashRegion = [&numbering, &hash](MemoryRegions::RegionID region) {
+        unsigned number = region == MemoryRegions::UnknownRegion ? 0 : numbering.size() + 1;
+        if (region != MemoryRegions::UnknownRegion) {
+            number = numbering.insert(std::make_pair(region, number)).first->second;
+        }
+        hashNumber(hash, number);
+    };
+
+    if (fun == nullptr) {
+        for (MemoryRegions::RegionID region : regions.getGlobalRegions()) {
+            hashRegion(region);
+        }
+        return;
+    }
+    for (const Instruction& inst : instructions(fun)) {
+        if (const LoadInst* load = SVFUtil::dyn_cast<LoadInst>(&inst)) {
+            hashRegion(regions.getRegion(load->getPointerOperand()));
+        } else if (const StoreInst* store = SVFUtil::dyn_cast<StoreInst>(&inst)) {
+            hashRegion(regions.getRegion(store->getPointerOperand()));
+        } else if (const CallBase* call = SVFUtil::dyn_cast<CallBase>(&inst)) {
+            for (const Use& arg : call->args()) {
+                if (arg->getType()->isPointerTy()) {
+                    for (MemoryRegions::RegionID region : regions.getReachableRegions(arg.get())) {
+                        hashRegion(region);
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+bool FunctionResultCache::replay(const Function* fun, uint64_t hash, PathReporter& reporter,
+                                 ExplorationSummary& summary) const {
+    auto entry = entries.find(fun->getName().str());
+    auto nodes = nodesByKey.find(fun);
+    if (entry == entries.end() || entry->second.hash != hash || nodes == nodesByKey.end()) {
+        return false;
+    }
+
+    std::vector<PathResult> results(entry->second.paths);
+    for (PathResult& result : results) {
+        for (NodeID& node : result.path) {
+            auto it = nodes->second.find(node);
+            if (it == nodes->second.end()) {
+                return false;
+            }
+            node = it->second;
+        }
+        auto it = nodes->second.find(result.target);
+        if (it == nodes->second.end()) {
+            return false;
+        }
+        result.target = it->second;
+    }
+
+    for (PathResult& result : results) {
+        reporter.report(std::move(result));
+    }
+    reporter.flush();
+    summary = entry->second.summary;
+    return true;
+}
+
+
+void FunctionResultCache::record(const Function* fun, uint64_t hash, const std::vector<PathResult>& results,
+                                 const ExplorationSummary& summary) {
+    auto nodes = nodesByKey.find(fun);
+    if (summary.interruptedBy != nullptr || nodes == nodesByKey.end()) {
+        return;
+    }
+    // Maps a node ID to its key, provided the node belongs to fun
+    auto toKey = [this, &nodes](NodeID& node) {
+        auto key = nodeKeys.find(node);
+        if (key == nodeKeys.end()) {
+            return false;
+        }
+        auto it = nodes->second.find(key->second);
+        if (it == nodes->second.end() || it->second != node) {
+            return false;
+        }
+        node = key->second;
+        return true;
+    };
+
+    Entry entry;
+    entry.hash = hash;
+    entry.summary = summary;
+    entry.paths = results;
+    for (PathResult& result : entry.paths) {
+        if (!std::all_of(result.path.begin(), result.path.end(), toKey)) {
+            return;
+        }
+        // The target of a bounded path is meaningless and need not be a node
+        if (!result.boundReason.empty()) {
+            result.target = 0;
+        } else if (!toKey(result.target)) {
+            return;
+        }
+    }
+    entries[fun->getName().str()] = std::move(entry);
+}
+
+
+bool FunctionResultCache::load(const string& fileName) {
+    ifstream in(fileName);
+    string line;
+    if (!in || !getline(in, line) || line != CACHE_FILE_HEADER) {
+        return false;
+    }
+
+    Entry* entry = nullptr;
+    PathResult* result = nullptr;
+    while (getline(in, line)) {
+        vector<string> fields = splitFields(line);
+        const string& tag = fields[0];
+        if (tag == "function" && fields.size() == 7) {
+            Entry& newEntry = entries[unescape(fields[1])];
+            newEntry = Entry();
+            istringstream counts(fields[2] + ' ' + fields[3] + ' ' + fields[4] + ' ' + fields[5] + ' ' + fields[6]);
+            counts >> newEntry.hash >> newEntry.summary.feasiblePaths >> newEntry.summary.infeasiblePaths
+                   >> newEntry.summary.unknownPaths >> newEntry.summary.boundedPaths;
+            if (!counts) {
+                return false;
+            }
+            entry = &newEntry;
+            result = nullptr;
+        } else if (tag == "path" && fields.size() == 6 && entry != nullptr) {
+            entry->paths.emplace_back();
+            result = &entry->paths.back();
+            int verdict = 0;
+            istringstream head(fields[1] + ' ' + fields[2]);
+            head >> verdict >> result->target;
+            if (!head || !readNumbers(fields[3], result->order) || !readNumbers(fields[4], result->path)) {
+                return false;
+            }
+            result->verdict = (z3::check_result) verdict;
+            result->boundReason = unescape(fields[5]);
+        } else if (tag == "constraint" && fields.size() == 2 && result != nullptr) {
+            result->constraints.push_back(unescape(fields[1]));
+        } else if (tag == "model" && fields.size() == 3 && result != nullptr) {
+            result->model.emplace_back(unescape(fields[1]), unescape(fields[2]));
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+bool FunctionResultCache::save(const string& fileName) const {
+    ofstream out(fileName);
+    if (!out) {
+        return false;
+    }
+    out << CACHE_FILE_HEADER << '\n';
+    for (const auto& entry : entries) {
+        if (!functionNames.count(entry.first)) {
+            continue;
+        }
+        const ExplorationSummary& summary = entry.second.summary;
+        out << "function\t" << escape(entry.first) << '\t' << entry.second.hash << '\t' << summary.feasiblePaths
+            << '\t' << summary.infeasiblePaths << '\t' << summary.unknownPaths << '\t' << summary.boundedPaths << '\n';
+        for (const PathResult& result : entry.second.paths) {
+            out << "path\t" << (int) result.verdict << '\t' << result.target << '\t';
+            writeNumbers(out, result.order);
+            out << '\t';
+            writeNumbers(out, result.path);
+            out << '\t' << escape(result.boundReason) << '\n';
+            for (const string& constraint : result.constraints) {
+                out << "constraint\t" << escape(constraint) << '\n';
+            }
+            for (const auto& value : result.model) {
+                out << "model\t" << escape(value.first) << '\t' << escape(value.second) << '\n';
+            }
+        }
+    }
+    return static_cast<bool>(out);
+}
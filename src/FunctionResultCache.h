@@ -0,0 +1,103 @@
+//===- FunctionResultCache.h -- Results of whole functions across runs ------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+/*
+ * Incremental re-analysis: the paths and counts reported for a function are saved together with a hash of everything
+ * its exploration depends on, and replayed instead of exploring the function again while the hash stays the same.
+ *
+ * The hash of a function covers its IR and that of every function it may call, directly or not, so changing a callee
+ * changes the hash of all its callers. It also covers the memory regions their loads, stores and calls access, as
+ * numbered from the first access on, since a new caller can merge regions of a function that did not change, and the
+ * explorer options that change which paths are reported. Metadata and attribute group numbers are left out of the IR,
+ * as they shift whenever another function changes.
+ *
+ * Paths refer to nodes by their position in the function rather than by node ID, which changes with every other
+ * function of the module.
+ */
+
+#ifndef FUNCTIONRESULTCACHE_H_
+#define FUNCTIONRESULTCACHE_H_
+
+#include "PathExplorer.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class FunctionResultCache {
+public:
+    /**
+     * @param regions      Regions the explorer splits memory into
+     * @param optionsHash  Hash of the options the results are computed with, see hashOptions()
+     */
+    FunctionResultCache(SVF::ICFG* icfg, const MemoryRegions& regions, uint64_t optionsHash);
+
+    /// Hash of the explorer options that change the paths reported, and of whether paths are reported at all
+    static uint64_t hashOptions(const ExplorerOptions& options, bool reportsPaths);
+
+    /// Hash of fun, its callees and the regions they access, combined with the options hash
+    uint64_t getHash(const llvm::Function* fun);
+
+    /**
+     * Reports the paths saved for fun, as exploring it would between beginFunction() and endFunction().
+     *
+     * @param summary  Set to the counts saved with the paths
+     * @return         False, leaving reporter untouched, if no results were saved for fun with this hash
+     */
+    bool replay(const llvm::Function* fun, uint64_t hash, PathReporter& reporter, ExplorationSummary& summary) const;
+
+    /// Saves the results of exploring fun, unless the exploration was interrupted or a path leaves fun
+    void record(const llvm::Function* fun, uint64_t hash, const std::vector<PathResult>& results,
+                const ExplorationSummary& summary);
+
+    /// Reads results saved by save(); returns false if the file is missing or was written by another format
+    bool load(const std::string& fileName);
+
+    /// Writes the results of every function still in the ICFG
+    bool save(const std::string& fileName) const;
+
+private:
+    /// Results of one function, with node keys in place of the node IDs of its paths
+    struct Entry {
+        uint64_t hash;
+        ExplorationSummary summary;
+        std::vector<PathResult> paths;
+    };
+
+    uint64_t getIRHash(const llvm::Function* fun);
+    void getCallees(const llvm::Function* fun, std::vector<const llvm::Function*>& callees) const;
+    void hashRegions(const llvm::Function* fun, std::unordered_map<MemoryRegions::RegionID, unsigned>& numbering,
+                     uint64_t& hash) const;
+
+    const MemoryRegions& regions;
+    uint64_t optionsHash;
+    std::unordered_map<SVF::NodeID, uint32_t> nodeKeys;  ///< Node ID -> position of the node in its function
+    std::unordered_map<const llvm::Function*, std::unordered_map<uint32_t, SVF::NodeID>> nodesByKey;
+    std::unordered_map<const llvm::Function*, std::vector<const SVF::CallBlockNode*>> callNodes;
+    std::unordered_set<std::string> functionNames;  ///< Functions with a body in the ICFG
+    std::unordered_map<const llvm::Function*, uint64_t> irHashes;
+    std::unordered_map<const llvm::Function*, uint64_t> hashes;
+    std::unordered_map<std::string, Entry> entries;
+};
+
+#endif /* FUNCTIONRESULTCACHE_H_ */
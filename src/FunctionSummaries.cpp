@@ -0,0 +1,410 @@
+//===- FunctionSummaries.cpp -- Path-condition to return-value summaries ----//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+#include "FunctionSummaries.h"
+#include "llvm/IR/Instructions.h"
+#include <unordered_set>
+
+using namespace SVF;
+using namespace llvm;
+using namespace z3;
+
+namespace {
+
+/**
+ * One entry of the stack exploring a summarized function: the node stepped into, its next out-edge to follow and the
+ * symbolic state after encoding it. Each frame owns one scope of the summary solver.
+ */
+struct SummaryFrame {
+    const ICFGNode* node;
+    ICFGNode::const_iterator nextEdge;
+    SymbolicState state;
+    unsigned numConstraints;  ///< Length of the path condition before the edge into node
+    unsigned length;          ///< Nodes on the path up to node
+
+    SummaryFrame(const ICFGNode* node, SymbolicState state, unsigned numConstraints, unsigned length)
+        : node(node), nextEdge(node->OutEdgeBegin()), state(std::move(state)), numConstraints(numConstraints),
+          length(length) {}
+};
+
+
+/// The exit node of fun that returns to retNode, or nullptr if there is none
+const FunExitBlockNode* getCalleeExit(const RetBlockNode* retNode, const SVFFunction* fun) {
+    for (const ICFGEdge* edge : retNode->getInEdges()) {
+        if (edge->isRetCFGEdge() && edge->getSrcNode()->getFun() == fun) {
+            return SVFUtil::dyn_cast<FunExitBlockNode>(edge->getSrcNode());
+        }
+    }
+    return nullptr;
+}
+
+} // End anonymous namespace
+
+
+const ICFGNode* FunctionSummaries::encodeStep(const ICFGNode* node, SymbolicState& state,
+                                              ConstraintEncoder::ConstraintList& constraints, unsigned instance) {
+    const CallBlockNode* callNode = SVFUtil::dyn_cast<CallBlockNode>(node);
+    if (callNode == nullptr) {
+        encoder.encodeNode(node, state, constraints);
+        return node;
+    }
+    encodeCall(callNode, state, constraints, instance);
+    return callNode->getRetBlockNode();
+}
+
+
+/**
+ * Binds the value of a call to a new symbol and constrains it to the return value of some case of some callee whose
+ * path condition holds for the actual arguments. Calls to external functions, recursive calls and callees whose
+ * summary is incomplete leave the value unconstrained. Memory the callee may write is forgotten either way.
+ */
+void FunctionSummaries::encodeCall(const CallBlockNode* callNode, SymbolicState& state,
+                                   ConstraintEncoder::ConstraintList& constraints, unsigned instance) {
+    const CallBase* call = SVFUtil::cast<CallBase>(callNode->getCallSite());
+
+    std::vector<const FunctionSummary*> calleeSummaries;
+    bool constrained = true;
+    for (const ICFGEdge* edge : callNode->getOutEdges()) {
+        if (!edge->isCallCFGEdge()) {
+            continue;
+        }
+        const FunEntryBlockNode* entry = SVFUtil::dyn_cast<FunEntryBlockNode>(edge->getDstNode());
+        const FunExitBlockNode* exit = nullptr;
+        if (entry != nullptr && !entry->getFun()->isDeclaration()) {
+            exit = getCalleeExit(callNode->getRetBlockNode(), entry->getFun());
+        }
+        const FunctionSummary* summary = exit != nullptr ? getSummary(entry, exit) : nullptr;
+        if (summary == nullptr || !summary->complete) {
+            constrained = false;
+            break;
+        }
+        calleeSummaries.push_back(summary);
+    }
+    constrained = constrained && !calleeSummaries.empty();
+
+    expr_vector actuals(ctx);
+    for (const Use& arg : call->args()) {
+        actuals.push_back(encoder.getValue(arg.get(), state));
+    }
+    std::string suffix = "@" + std::to_string(instance);
+    bool hasResult = !call->getType()->isVoidTy();
+    expr result = hasResult ? encoder.makeSymbol(call, suffix) : ctx.bool_val(true);
+
+    if (constrained) {
+        expr_vector disjuncts(ctx);
+        for (const FunctionSummary* summary : calleeSummaries) {
+            // Formals become the actual arguments, every other symbol is renamed apart for this call
+            expr_vector from(ctx);
+            expr_vector to(ctx);
+            for (unsigned i = 0; i < summary->formals.size(); i++) {
+                expr formal = summary->formals[i];
+                from.push_back(formal);
+                if (i < actuals.size() && z3::eq(formal.get_sort(), actuals[i].get_sort())) {
+                    to.push_back(actuals[i]);
+                } else {
+                    to.push_back(ctx.constant((formal.decl().name().str() + suffix).c_str(), formal.get_sort()));
+                }
+            }
+            for (unsigned i = 0; i < summary->inputs.size(); i++) {
+                expr input = summary->inputs[i];
+                from.push_back(input);
+                to.push_back(ctx.constant((input.decl().name().str() + suffix).c_str(), input.get_sort()));
+            }
+
+            for (const SummaryCase& summaryCase : summary->cases) {
+                expr disjunct = summaryCase.pathCondition;
+                disjunct = disjunct.substitute(from, to);
+                if (hasResult && summary->returnsValue
+                        && z3::eq(result.get_sort(), summaryCase.returnValue.get_sort())) {
+                    expr returnValue = summaryCase.returnValue;
+                    disjunct = disjunct && result == returnValue.substitute(from, to);
+                }
+                disjuncts.push_back(disjunct);
+            }
+        }
+        constraints.push_back(mk_or(disjuncts));
+    }
+
+    if (hasResult) {
+        encoder.bindValue(call, result, state);
+    }
+    encoder.havocMemory(call, state);
+}
+
+
+std::shared_ptr<const SummaryTable::Entry> SummaryTable::find(const ICFGNode* entry) const {
+    std::lock_guard<std::mutex> lock(tableMutex);
+    auto it = entries.find(entry);
+    return it != entries.end() ? it->second : nullptr;
+}
+
+
+void SummaryTable::publish(const ICFGNode* entry, const std::shared_ptr<const Entry>& summary) {
+    std::lock_guard<std::mutex> lock(tableMutex);
+    entries.emplace(entry, summary);
+}
+
+
+/**
+ * The summary of the function entered at entry, or nullptr for a recursive call to a function being summarized.
+ * Summaries are parsed from the shared table when possible; one built here is published to it. Workers never wait for
+ * each other, so two of them may build the same summary, of which the first one published is kept.
+ */
+const FunctionSummary* FunctionSummaries::getSummary(const FunEntryBlockNode* entry, const FunExitBlockNode* exit) {
+    auto it = summaries.find(entry);
+    if (it != summaries.end()) {
+        if (!it->second->building) {
+            return it->second.get();
+        }
+        // Every summary entered since depends on leaving this call unconstrained
+        for (auto inner = buildStack.rbegin(); *inner != it->second.get(); ++inner) {
+            (*inner)->shareable = false;
+        }
+        return nullptr;
+    }
+    FunctionSummary* summary = new FunctionSummary(ctx);
+    summaries.emplace(entry, std::unique_ptr<FunctionSummary>(summary));
+    if (parseShared(entry, *summary)) {
+        summary->building = false;
+        return summary;
+    }
+    buildStack.push_back(summary);
+    summarize(entry, exit, *summary);
+    buildStack.pop_back();
+    summary->building = false;
+    // A summary cut short by the budget is not what another exploration would build
+    if (summary->shareable && (budget == nullptr || !budget->isExhausted())) {
+        publish(entry, *summary);
+    }
+    return summary;
+}
+
+
+/// Binds the formal parameters of the function entered at entry to their symbols in state
+void FunctionSummaries::addFormals(const FunEntryBlockNode* entry, FunctionSummary& summary,
+                                   SymbolicState& entryState) {
+    for (const Argument& arg : entry->getFun()->getLLVMFun()->args()) {
+        summary.formals.push_back(encoder.getValue(&arg, entryState));
+    }
+}
+
+
+/**
+ * Parses the summary published for entry into this worker's context. The symbols are declared by name, so they are
+ * the ones the encoder makes for the formals and every other reference to them in the context.
+ *
+ * @return  False if no summary was published for entry or its text does not parse, leaving summary untouched
+ */
+bool FunctionSummaries::parseShared(const FunEntryBlockNode* entry, FunctionSummary& summary) {
+    std::shared_ptr<const SummaryTable::Entry> shared = table.find(entry);
+    if (!shared) {
+        return false;
+    }
+    std::vector<SummaryCase> cases;
+    try {
+        expr_vector assertions = ctx.parse_string(shared->cases.c_str());
+        // Each case is its path condition, followed by (= __ret<i> value) if the function returns one
+        unsigned step = shared->returnsValue ? 2 : 1;
+        for (unsigned i = 0; i + step <= assertions.size(); i += step) {
+            cases.emplace_back(assertions[i], shared->returnsValue ? assertions[i + 1].arg(1) : ctx.bool_val(true));
+        }
+    } catch (const z3::exception&) {
+        return false;
+    }
+    SymbolicState entryState;
+    addFormals(entry, summary, entryState);
+    summary.returnsValue = shared->returnsValue;
+    summary.complete = shared->complete;
+    summary.cases = std::move(cases);
+    collectInputs(summary);
+    return true;
+}
+
+
+/// Publishes summary as SMT-LIB text declaring its symbols and asserting the parts of each case in turn
+void FunctionSummaries::publish(const FunEntryBlockNode* entry, const FunctionSummary& summary) {
+    std::string text;
+    auto declare = [&text](const expr& symbol) {
+        text += "(declare-fun " + symbol.to_string() + " () " + symbol.get_sort().to_string() + ")\n";
+    };
+    for (unsigned i = 0; i < summary.formals.size(); i++) {
+        if (summary.formals[i].is_const()) {
+            declare(summary.formals[i]);
+        }
+    }
+    for (unsigned i = 0; i < summary.inputs.size(); i++) {
+        declare(summary.inputs[i]);
+    }
+    for (unsigned i = 0; i < summary.cases.size(); i++) {
+        text += "(assert " + summary.cases[i].pathCondition.to_string() + ")\n";
+        if (summary.returnsValue) {
+            expr returnValue = summary.cases[i].returnValue;
+            std::string name = "|__ret" + std::to_string(i) + "|";
+            text += "(declare-fun " + name + " () " + returnValue.get_sort().to_string() + ")\n";
+            text += "(assert (= " + name + " " + returnValue.to_string() + "))\n";
+        }
+    }
+
+    std::shared_ptr<SummaryTable::Entry> shared(new SummaryTable::Entry());
+    shared->cases = std::move(text);
+    shared->returnsValue = summary.returnsValue;
+    shared->complete = summary.complete;
+    table.publish(entry, shared);
+}
+
+
+/**
+ * Explores every path from entry to exit with a solver of its own, dropping infeasible prefixes at each branch, and
+ * records the path condition and returned value of each path reaching exit.
+ */
+void FunctionSummaries::summarize(const FunEntryBlockNode* entry, const FunExitBlockNode* exit,
+                                  FunctionSummary& summary) {
+    const Function* fun = entry->getFun()->getLLVMFun();
+    summary.returnsValue = !fun->getReturnType()->isVoidTy();
+    SymbolicState entryState;
+    addFormals(entry, summary, entryState);
+
+    solver s(ctx);
+    ConstraintEncoder::ConstraintList pathCondition;
+    ConstraintEncoder::ConstraintList nodeConstraints;
+    std::unordered_map<const ICFGNode*, unsigned> occurrences;
+    std::vector<SummaryFrame> frames;
+    occurrences[entry]++;
+    s.push();
+    frames.emplace_back(entry, std::move(entryState), 0, 0);
+
+    while (!frames.empty()) {
+        if (budget != nullptr && budget->isExhausted()) {
+            summary.complete = false;
+            break;
+        }
+        SummaryFrame& top = frames.back();
+        if (top.nextEdge == top.node->OutEdgeEnd()) {
+            occurrences[top.node]--;
+            if (const RetBlockNode* retNode = SVFUtil::dyn_cast<RetBlockNode>(top.node)) {
+                occurrences[retNode->getCallBlockNode()]--;
+            }
+            pathCondition.erase(pathCondition.begin() + top.numConstraints, pathCondition.end());
+            frames.pop_back();
+            s.pop();
+            continue;
+        }
+        const ICFGEdge* edge = *top.nextEdge;
+        ++top.nextEdge;
+        const ICFGNode* succNode = edge->getDstNode();
+
+        unsigned numConstraints = pathCondition.size();
+        // The last successor of a node takes its state over, so only forks copy it
+        SymbolicState succState = top.nextEdge != top.node->OutEdgeEnd() ? SymbolicState(top.state)
+                                                                        : std::move(top.state);
+        s.push();
+        expr branchCond(ctx);
+        if (encoder.encodeEdge(edge, succState, branchCond)) {
+            s.add(branchCond);
+            pathCondition.push_back(branchCond);
+            check_result verdict;
+            solverLimits.apply(s, budget);
+            {
+                Profiler::Timer timer(profile, Profiler::Solving);
+                verdict = s.check();
+            }
+            if (verdict == z3::unsat) {
+                pathCondition.erase(pathCondition.begin() + numConstraints, pathCondition.end());
+                s.pop();
+                continue;
+            }
+        }
+
+        if (succNode == exit) {
+            if (maxSummaryPaths > 0 && summary.cases.size() >= maxSummaryPaths) {
+                summary.complete = false;
+                break;
+            }
+            expr returnValue = ctx.bool_val(true);
+            const IntraBlockNode* retInstNode = SVFUtil::dyn_cast<IntraBlockNode>(top.node);
+            const ReturnInst* ret = retInstNode ? SVFUtil::dyn_cast<ReturnInst>(retInstNode->getInst()) : nullptr;
+            if (ret != nullptr && ret->getReturnValue() != nullptr) {
+                returnValue = encoder.getValue(ret->getReturnValue(), succState);
+            } else if (summary.returnsValue) {
+                returnValue = encoder.makeSymbol("%" + fun->getName().str() + "@ret", fun->getReturnType());
+            }
+            expr_vector conjuncts(ctx);
+            for (const expr& constraint : pathCondition) {
+                conjuncts.push_back(constraint);
+            }
+            summary.cases.emplace_back(mk_and(conjuncts), returnValue);
+            pathCondition.erase(pathCondition.begin() + numConstraints, pathCondition.end());
+            s.pop();
+            continue;
+        }
+
+        // Paths cut by a bound are missing from the cases, so the summary is not applied at call sites
+        if ((maxPathDepth > 0 && top.length + 1 > maxPathDepth) || occurrences[succNode] > maxLoopUnroll) {
+            summary.complete = false;
+            pathCondition.erase(pathCondition.begin() + numConstraints, pathCondition.end());
+            s.pop();
+            continue;
+        }
+
+        unsigned length = top.length + 1;
+        occurrences[succNode]++;
+        nodeConstraints.clear();
+        const ICFGNode* steppedNode = encodeStep(succNode, succState, nodeConstraints, length);
+        if (steppedNode != succNode) {
+            occurrences[steppedNode]++;
+            length++;
+        }
+        for (const expr& constraint : nodeConstraints) {
+            s.add(constraint);
+            pathCondition.push_back(constraint);
+        }
+        frames.emplace_back(steppedNode, std::move(succState), numConstraints, length);  // invalidates top
+    }
+    collectInputs(summary);
+}
+
+
+/// Gathers the uninterpreted constants of the cases other than the formals
+void FunctionSummaries::collectInputs(FunctionSummary& summary) {
+    std::unordered_set<unsigned> visited;
+    for (unsigned i = 0; i < summary.formals.size(); i++) {
+        visited.insert(summary.formals[i].id());
+    }
+    std::vector<expr> worklist;
+    for (const SummaryCase& summaryCase : summary.cases) {
+        worklist.push_back(summaryCase.pathCondition);
+        worklist.push_back(summaryCase.returnValue);
+    }
+    while (!worklist.empty()) {
+        expr e = worklist.back();
+        worklist.pop_back();
+        if (!visited.insert(e.id()).second || !e.is_app()) {
+            continue;
+        }
+        if (e.num_args() == 0 && e.decl().decl_kind() == Z3_OP_UNINTERPRETED) {
+            summary.inputs.push_back(e);
+        }
+        for (unsigned i = 0; i < e.num_args(); i++) {
+            worklist.push_back(e.arg(i));
+        }
+    }
+}
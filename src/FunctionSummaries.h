@@ -0,0 +1,141 @@
+//===- FunctionSummaries.h -- Path-condition to return-value summaries ------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+/*
+ * Calls are never inlined into the paths of their caller. The first time a function is called, every path from its
+ * entry to its exit is explored once with its formal parameters left symbolic, giving one case per feasible path: the
+ * path condition and the returned value. Each call site then steps from its CallBlockNode straight to its RetBlockNode
+ * and asserts that one of the cases holds for the actual arguments.
+ *
+ * Z3 expressions belong to the context they were built in, so every worker keeps the summaries it uses in its own
+ * context. Once built, a summary is also published to a SummaryTable as SMT-LIB text, from which the other workers and
+ * later explorations of the run parse it instead of exploring the callee again.
+ */
+
+#ifndef FUNCTIONSUMMARIES_H_
+#define FUNCTIONSUMMARIES_H_
+
+#include "ConstraintEncoder.h"
+#include "Profiler.h"
+#include "ResourceLimits.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/// One feasible path from the entry to the exit of a function
+struct SummaryCase {
+    z3::expr pathCondition;
+    z3::expr returnValue;  ///< Only meaningful if the function returns a value
+
+    SummaryCase(const z3::expr& pathCondition, const z3::expr& returnValue)
+        : pathCondition(pathCondition), returnValue(returnValue) {}
+};
+
+
+struct FunctionSummary {
+    z3::expr_vector formals;  ///< Symbols the cases use for the formal parameters
+    z3::expr_vector inputs;   ///< Other symbols of the cases (loaded globals, results of unknown calls)
+    std::vector<SummaryCase> cases;
+    bool returnsValue;
+    bool complete;  ///< False if paths were cut by a bound, so the cases do not cover every execution
+    bool building;  ///< Set while the function's own paths are explored, so recursive calls are not summarized
+    bool shareable; ///< False if a recursive call was left unconstrained, as the cases then depend on the caller
+
+    explicit FunctionSummary(z3::context& ctx)
+        : formals(ctx), inputs(ctx), returnsValue(false), complete(true), building(true), shareable(true) {}
+};
+
+
+/// Summaries shared by every worker and exploration of a run, independent of any Z3 context
+class SummaryTable {
+public:
+    struct Entry {
+        std::string cases;  ///< Declarations of the symbols, then per case its path condition and returned value
+        bool returnsValue;
+        bool complete;
+    };
+
+    /// The summary published for the function entered at entry, or nullptr if there is none yet
+    std::shared_ptr<const Entry> find(const SVF::ICFGNode* entry) const;
+
+    /// Publishes the summary of the function entered at entry, unless one was published already
+    void publish(const SVF::ICFGNode* entry, const std::shared_ptr<const Entry>& summary);
+
+private:
+    std::unordered_map<const SVF::ICFGNode*, std::shared_ptr<const Entry>> entries;  ///< By entry node
+    mutable std::mutex tableMutex;
+};
+
+
+class FunctionSummaries {
+public:
+    /**
+     * @param maxLoopUnroll    Times a node may be re-entered on one path of a summarized function
+     * @param maxPathDepth     Nodes a path of a summarized function may contain, 0 for no limit
+     * @param maxSummaryPaths  Cases kept per function before its summary is given up as incomplete
+     * @param solverLimits     Limits of the feasibility checks of summarized paths
+     * @param budget           Budget of the run, whose exhaustion leaves a summary incomplete; may be null
+     * @param table            Summaries shared with other workers, built with the same bounds
+     * @param profile          Counts the solver calls of summarized paths; may be null
+     */
+    FunctionSummaries(ConstraintEncoder& encoder, unsigned maxLoopUnroll, unsigned maxPathDepth,
+                      unsigned maxSummaryPaths, const SolverLimits& solverLimits, ResourceBudget* budget,
+                      SummaryTable& table, Profiler::Counters* profile)
+        : encoder(encoder), ctx(encoder.getContext()), maxLoopUnroll(maxLoopUnroll), maxPathDepth(maxPathDepth),
+          maxSummaryPaths(maxSummaryPaths), solverLimits(solverLimits), budget(budget), table(table),
+          profile(profile) {}
+
+    /**
+     * Steps into node. A call node is encoded through the summaries of its callees and immediately followed by its
+     * return node; any other node is encoded as is.
+     *
+     * @param instance  Distinguishes this step from others on the same path, used to rename the inputs of callees
+     * @return          The node stepped into last, i.e. the return node of a call or node itself
+     */
+    const SVF::ICFGNode* encodeStep(const SVF::ICFGNode* node, SymbolicState& state,
+                                    ConstraintEncoder::ConstraintList& constraints, unsigned instance);
+
+private:
+    void encodeCall(const SVF::CallBlockNode* callNode, SymbolicState& state,
+                    ConstraintEncoder::ConstraintList& constraints, unsigned instance);
+    const FunctionSummary* getSummary(const SVF::FunEntryBlockNode* entry, const SVF::FunExitBlockNode* exit);
+    void summarize(const SVF::FunEntryBlockNode* entry, const SVF::FunExitBlockNode* exit, FunctionSummary& summary);
+    void collectInputs(FunctionSummary& summary);
+    void addFormals(const SVF::FunEntryBlockNode* entry, FunctionSummary& summary, SymbolicState& entryState);
+    bool parseShared(const SVF::FunEntryBlockNode* entry, FunctionSummary& summary);
+    void publish(const SVF::FunEntryBlockNode* entry, const FunctionSummary& summary);
+
+    ConstraintEncoder& encoder;
+    z3::context& ctx;
+    unsigned maxLoopUnroll;
+    unsigned maxPathDepth;
+    unsigned maxSummaryPaths;
+    SolverLimits solverLimits;
+    ResourceBudget* budget;
+    SummaryTable& table;
+    Profiler::Counters* profile;
+    std::unordered_map<const SVF::ICFGNode*, std::unique_ptr<FunctionSummary>> summaries;  ///< By entry node
+    std::vector<FunctionSummary*> buildStack;  ///< Summaries being built, innermost last
+};
+
+#endif /* FUNCTIONSUMMARIES_H_ */
@@ -0,0 +1,351 @@
+//===- MemoryRegions.cpp -- Alias-free partition of memory ------------------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+#include "MemoryRegions.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Instructions.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <set>
+
+using namespace SVF;
+using namespace llvm;
+
+namespace {
+
+const char CACHE_MAGIC[8] = {'S', 'V', 'F', 'X', 'R', 'E', 'G', '2'};
+
+/**
+ * Start of a cache file. It is followed by arrays of 32-bit region IDs: the region of every object, of every access,
+ * the global regions, then numPassed + 1 offsets into the reachable regions of the call arguments, and those regions.
+ */
+struct CacheHeader {
+    char magic[8];
+    uint64_t moduleHash;
+    uint32_t numObjects;
+    uint32_t numAccessed;
+    uint32_t numPassed;
+    uint32_t numRegions;
+    uint32_t numGlobals;
+    uint32_t numReachable;
+};
+
+
+/// Union-find over the base object nodes of the PAG
+class ObjectPartition {
+public:
+    NodeID find(NodeID node) {
+        auto it = parent.insert(std::make_pair(node, node)).first;
+        if (it->second == node) {
+            return node;
+        }
+        NodeID root = find(it->second);
+        parent[node] = root;
+        return root;
+    }
+
+    void merge(NodeID a, NodeID b) {
+        NodeID rootA = find(a);
+        NodeID rootB = find(b);
+        if (rootA != rootB) {
+            parent[std::max(rootA, rootB)] = std::min(rootA, rootB);
+        }
+    }
+
+private:
+    std::unordered_map<NodeID, NodeID> parent;
+};
+
+
+/**
+ * Appends the base objects a pointer or the contents of an object may point to. Returns false if one of them is not
+ * backed by an LLVM value (the black hole or a constant object), in which case it may point anywhere. The objects
+ * that are backed by a value are appended either way.
+ */
+bool getTargets(PAG* pag, BVDataPTAImpl* pta, NodeID node, std::vector<NodeID>& targets) {
+    bool known = true;
+    for (NodeID obj : pta->getPts(node)) {
+        NodeID base = pag->getBaseObjNode(obj);
+        if (!pag->getPAGNode(base)->hasValue()) {
+            known = false;
+            continue;
+        }
+        targets.push_back(base);
+    }
+    return known;
+}
+
+} // End anonymous namespace
+
+
+const MemoryRegions::RegionID MemoryRegions::UnknownRegion;
+const MemoryRegions::ObjectID MemoryRegions::NoObject;
+
+
+MemoryRegions::MemoryRegions(ICFG* icfg, PAG* pag, BVDataPTAImpl* pta) : MemoryRegions(icfg) {
+    if (pta == nullptr) {
+        globalRegions.push_back(UnknownRegion);
+        return;
+    }
+    partition(pag, pta);
+}
+
+
+MemoryRegions::MemoryRegions(ICFG* icfg) : unknownRegions(1, UnknownRegion), numRegions(1) {
+    for (ICFG::iterator it = icfg->begin(); it != icfg->end(); ++it) {
+        const Instruction* inst = nullptr;
+        if (const IntraBlockNode* intraNode = SVFUtil::dyn_cast<IntraBlockNode>(it->second)) {
+            inst = intraNode->getInst();
+        } else if (const CallBlockNode* callNode = SVFUtil::dyn_cast<CallBlockNode>(it->second)) {
+            inst = callNode->getCallSite();
+            for (const Use& arg : SVFUtil::cast<CallBase>(inst)->args()) {
+                if (arg->getType()->isPointerTy()) {
+                    passed.push_back(arg.get());
+                }
+            }
+        }
+        if (inst == nullptr) {
+            continue;
+        }
+        addObjects(inst);
+        if (const LoadInst* load = SVFUtil::dyn_cast<LoadInst>(inst)) {
+            accessed.push_back(load->getPointerOperand());
+        } else if (const StoreInst* store = SVFUtil::dyn_cast<StoreInst>(inst)) {
+            accessed.push_back(store->getPointerOperand());
+        }
+    }
+
+    objectRegions.assign(objects.size(), UnknownRegion);
+}
+
+
+void MemoryRegions::partition(PAG* pag, BVDataPTAImpl* pta) {
+    // Objects one load or store may access share a region. A pointer that may also point anywhere accesses
+    // UnknownRegion, so the objects it may point to are merged into that region as well.
+    ObjectPartition partition;
+    std::unordered_map<const Value*, NodeID> accessedObject;  // Some object each accessed pointer may point to
+    std::vector<NodeID> unknownObjects;
+    for (const Value* ptr : accessed) {
+        std::vector<NodeID> targets;
+        if (!pag->hasValueNode(ptr)) {
+            continue;
+        }
+        if (!getTargets(pag, pta, pag->getValueNode(ptr), targets)) {
+            unknownObjects.insert(unknownObjects.end(), targets.begin(), targets.end());
+            continue;
+        }
+        if (targets.empty()) {
+            continue;
+        }
+        for (NodeID target : targets) {
+            partition.merge(targets.front(), target);
+        }
+        accessedObject[ptr] = targets.front();
+    }
+    for (NodeID obj : unknownObjects) {
+        partition.merge(unknownObjects.front(), obj);
+    }
+
+    // Regions are numbered in order of their first object, so the numbering only depends on the ICFG
+    std::unordered_map<NodeID, RegionID> regionOfRoot;
+    if (!unknownObjects.empty()) {
+        regionOfRoot[partition.find(unknownObjects.front())] = UnknownRegion;
+    }
+    auto getRegionOf = [&](NodeID obj) {
+        auto it = regionOfRoot.insert(std::make_pair(partition.find(obj), numRegions));
+        if (it.second) {
+            numRegions++;
+        }
+        return it.first->second;
+    };
+    std::set<RegionID> globals;
+    for (ObjectID id = 0; id < objects.size(); id++) {
+        objectRegions[id] = getRegionOf(pag->getObjectNode(objects[id]));
+        if (SVFUtil::isa<GlobalVariable>(objects[id])) {
+            globals.insert(objectRegions[id]);
+        }
+    }
+    globalRegions.assign(globals.begin(), globals.end());
+    for (const Value* ptr : accessed) {
+        auto access = accessedObject.find(ptr);
+        if (access != accessedObject.end()) {
+            pointerRegions[ptr] = getRegionOf(access->second);
+        }
+    }
+
+    // A callee may follow the pointers stored in the objects passed to it
+    for (const Value* arg : passed) {
+        if (argumentRegions.count(arg)) {
+            continue;
+        }
+        std::vector<NodeID> worklist;
+        std::set<NodeID> reached;
+        std::set<RegionID> regions;
+        bool known = pag->hasValueNode(arg) && getTargets(pag, pta, pag->getValueNode(arg), worklist);
+        while (!worklist.empty()) {
+            NodeID obj = worklist.back();
+            worklist.pop_back();
+            if (!reached.insert(obj).second) {
+                continue;
+            }
+            regions.insert(getRegionOf(obj));
+            known = getTargets(pag, pta, obj, worklist) && known;
+        }
+        if (!known) {
+            regions.insert(UnknownRegion);
+        }
+        argumentRegions[arg].assign(regions.begin(), regions.end());
+    }
+}
+
+
+std::unique_ptr<MemoryRegions> MemoryRegions::load(const std::string& fileName, uint64_t moduleHash, ICFG* icfg) {
+    std::ifstream in(fileName, std::ios::binary);
+    if (!in) {
+        return nullptr;
+    }
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (in.bad()) {
+        return nullptr;
+    }
+    std::unique_ptr<MemoryRegions> regions(new MemoryRegions(icfg));
+    return regions->read(data.data(), data.size(), moduleHash) ? std::move(regions) : nullptr;
+}
+
+
+bool MemoryRegions::save(const std::string& fileName, uint64_t moduleHash) const {
+    std::vector<uint32_t> reachableOffsets(1, 0);
+    std::vector<uint32_t> reachable;
+    for (const Value* arg : passed) {
+        const std::vector<RegionID>& argRegions = getReachableRegions(arg);
+        reachable.insert(reachable.end(), argRegions.begin(), argRegions.end());
+        reachableOffsets.push_back(reachable.size());
+    }
+    std::vector<uint32_t> accessRegions;
+    for (const Value* ptr : accessed) {
+        accessRegions.push_back(getRegion(ptr));
+    }
+
+    CacheHeader header;
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.moduleHash = moduleHash;
+    header.numObjects = objects.size();
+    header.numAccessed = accessed.size();
+    header.numPassed = passed.size();
+    header.numRegions = numRegions;
+    header.numGlobals = globalRegions.size();
+    header.numReachable = reachable.size();
+
+    std::ofstream out(fileName, std::ios::binary);
+    if (!out) {
+        return false;
+    }
+    auto writeIds = [&out](const std::vector<uint32_t>& ids) {
+        out.write(reinterpret_cast<const char*>(ids.data()), ids.size() * sizeof(uint32_t));
+    };
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writeIds(objectRegions);
+    writeIds(accessRegions);
+    writeIds(globalRegions);
+    writeIds(reachableOffsets);
+    writeIds(reachable);
+    return bool(out);
+}
+
+
+/// Restores the regions from the contents of a cache file, checking it against the modules and the objects and accesses
+bool MemoryRegions::read(const char* data, size_t size, uint64_t moduleHash) {
+    CacheHeader header;
+    if (size < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.moduleHash != moduleHash
+            || header.numObjects != objects.size() || header.numAccessed != accessed.size()
+            || header.numPassed != passed.size() || header.numRegions == 0) {
+        return false;
+    }
+    size_t numIds = (size_t) header.numObjects + header.numAccessed + header.numGlobals + header.numPassed + 1
+                    + header.numReachable;
+    if (size != sizeof(header) + numIds * sizeof(uint32_t)) {
+        return false;
+    }
+    std::vector<uint32_t> ids(numIds);
+    std::memcpy(ids.data(), data + sizeof(header), numIds * sizeof(uint32_t));
+    const uint32_t* objectIds = ids.data();
+    const uint32_t* accessIds = objectIds + header.numObjects;
+    const uint32_t* globalIds = accessIds + header.numAccessed;
+    const uint32_t* offsets = globalIds + header.numGlobals;
+    const uint32_t* reachable = offsets + header.numPassed + 1;
+    auto isRegion = [&header](uint32_t id) { return id < header.numRegions; };
+    if (!std::all_of(objectIds, offsets, isRegion) || !std::all_of(reachable, objectIds + numIds, isRegion)
+            || !std::is_sorted(offsets, reachable) || offsets[header.numPassed] > header.numReachable) {
+        return false;
+    }
+
+    objectRegions.assign(objectIds, accessIds);
+    for (unsigned i = 0; i < accessed.size(); i++) {
+        if (accessIds[i] != UnknownRegion) {
+            pointerRegions[accessed[i]] = accessIds[i];
+        }
+    }
+    globalRegions.assign(globalIds, offsets);
+    for (unsigned i = 0; i < passed.size(); i++) {
+        argumentRegions[passed[i]].assign(reachable + offsets[i], reachable + offsets[i + 1]);
+    }
+    numRegions = header.numRegions;
+    return true;
+}
+
+
+const std::vector<MemoryRegions::RegionID>& MemoryRegions::getReachableRegions(const Value* arg) const {
+    auto it = argumentRegions.find(arg);
+    return it == argumentRegions.end() ? unknownRegions : it->second;
+}
+
+
+void MemoryRegions::addObject(const Value* object) {
+    if (objectIds.insert(std::make_pair(object, (ObjectID) objects.size())).second) {
+        objects.push_back(object);
+    }
+}
+
+
+/// Numbers inst if it is an alloca, and the globals it uses, directly or through a constant expression
+void MemoryRegions::addObjects(const Instruction* inst) {
+    if (SVFUtil::isa<AllocaInst>(inst)) {
+        addObject(inst);
+    }
+    for (const Use& operand : inst->operands()) {
+        if (SVFUtil::isa<GlobalVariable>(operand.get())) {
+            addObject(operand.get());
+        } else if (const ConstantExpr* constExpr = SVFUtil::dyn_cast<ConstantExpr>(operand.get())) {
+            for (const Use& constOperand : constExpr->operands()) {
+                if (SVFUtil::isa<GlobalVariable>(constOperand.get())) {
+                    addObject(constOperand.get());
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,126 @@
+//===- MemoryRegions.h -- Alias-free partition of memory --------------------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+/*
+ * Splits memory into regions that no load, store or call can access across, using the points-to sets of Andersen's
+ * analysis: two abstract objects share a region if one pointer may point to both. The encoder keeps one array per
+ * region, so a store through a symbolic pointer only touches the array of its own region.
+ *
+ * Stack slots and globals are numbered here as well, which gives them the same concrete address in every worker.
+ *
+ * The points-to analysis is the most expensive step after the PAG is built, so the regions can be saved to a cache
+ * file tagged with a hash of the analyzed modules. A later run on the same modules reads the file and skips the
+ * analysis. Objects, loads, stores and calls are identified by their position in the ICFG, which only depends on the
+ * modules.
+ */
+
+#ifndef MEMORYREGIONS_H_
+#define MEMORYREGIONS_H_
+
+#include "Graphs/ICFG.h"
+#include "WPA/Andersen.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class MemoryRegions {
+public:
+    typedef unsigned RegionID;
+    typedef unsigned ObjectID;
+
+    /// Memory of pointers that may point to objects the analysis does not know, with the known objects they may point
+    /// to, and all memory without points-to results
+    static const RegionID UnknownRegion = 0;
+    static const ObjectID NoObject = ~0u;
+
+    /**
+     * @param icfg  Every load, store and call of the ICFG is partitioned
+     * @param pag   PAG the points-to sets refer to
+     * @param pta   Points-to results, nullptr to put all memory into one region
+     */
+    MemoryRegions(SVF::ICFG* icfg, SVF::PAG* pag, SVF::BVDataPTAImpl* pta);
+
+    /// Regions saved for modules with the given hash, or null if the file is missing, stale or does not match icfg
+    static std::unique_ptr<MemoryRegions> load(const std::string& fileName, uint64_t moduleHash, SVF::ICFG* icfg);
+
+    bool save(const std::string& fileName, uint64_t moduleHash) const;
+
+    /// ID of an alloca or global variable, or NoObject
+    ObjectID getObjectId(const llvm::Value* object) const {
+        auto it = objectIds.find(object);
+        return it == objectIds.end() ? NoObject : it->second;
+    }
+
+    const llvm::Value* getObject(ObjectID id) const {
+        return objects[id];
+    }
+
+    unsigned getNumObjects() const {
+        return objects.size();
+    }
+
+    RegionID getObjectRegion(ObjectID id) const {
+        return objectRegions[id];
+    }
+
+    /// Region a load or store through ptr accesses
+    RegionID getRegion(const llvm::Value* ptr) const {
+        auto it = pointerRegions.find(ptr);
+        return it == pointerRegions.end() ? UnknownRegion : it->second;
+    }
+
+    /// Regions a callee may reach through a pointer argument, following pointers stored in memory
+    const std::vector<RegionID>& getReachableRegions(const llvm::Value* arg) const;
+
+    /// Regions holding a global variable, which any callee may write
+    const std::vector<RegionID>& getGlobalRegions() const {
+        return globalRegions;
+    }
+
+    unsigned getNumRegions() const {
+        return numRegions;
+    }
+
+private:
+    /// Numbers the objects of icfg and collects its accesses, leaving all memory in UnknownRegion
+    explicit MemoryRegions(SVF::ICFG* icfg);
+
+    void partition(SVF::PAG* pag, SVF::BVDataPTAImpl* pta);
+    bool read(const char* data, size_t size, uint64_t moduleHash);
+    void addObject(const llvm::Value* object);
+    void addObjects(const llvm::Instruction* inst);
+
+    std::unordered_map<const llvm::Value*, ObjectID> objectIds;
+    std::vector<const llvm::Value*> objects;  ///< ID -> alloca or global, in ICFG order
+    std::vector<RegionID> objectRegions;
+    std::vector<const llvm::Value*> accessed;  ///< Pointer operands of loads and stores, in ICFG order
+    std::vector<const llvm::Value*> passed;    ///< Pointer arguments of calls, in ICFG order
+    std::unordered_map<const llvm::Value*, RegionID> pointerRegions;
+    std::unordered_map<const llvm::Value*, std::vector<RegionID>> argumentRegions;
+    std::vector<RegionID> globalRegions;
+    std::vector<RegionID> unknownRegions;  ///< Only UnknownRegion, for arguments without points-to results
+    unsigned numRegions;
+};
+
+#endif /* MEMORYREGIONS_H_ */
@@ -0,0 +1,1082 @@
+//===- PathExplorer.cpp -- Symbolic exploration of ICFG paths ---------------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+#include "PathExplorer.h"
+#include "ConstraintSlicer.h"
+#include "DistanceMap.h"
+#include "FunctionSummaries.h"
+#include "PathTree.h"
+#include "StateMerger.h"
+#include "StateScheduler.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <unordered_map>
+
+using namespace SVF;
+using namespace z3;
+using namespace std;
+
+namespace {
+
+/// Name prefix of the literals tracking path constraints for UNSAT cores, which are left out of models
+const string CORE_TRACKER_PREFIX = "__core";
+
+/// Model values are printed by Z3, except bitvectors, which are read as the two's complement C integers they encode
+string formatValue(const expr& value) {
+    unsigned width = value.is_bv() ? value.get_sort().bv_size() : 0;
+    uint64_t bits = 0;
+    if (width == 0 || width > 64 || !value.is_numeral_u64(bits)) {
+        return value.to_string();
+    }
+    if (width < 64 && (bits >> (width - 1)) & 1) {
+        bits |= ~0ULL << width;
+    }
+    return std::to_string((int64_t) bits);
+}
+
+
+/**
+ * One deque of WorkItems per worker. The owner pushes and pops at the back, thieves steal from the front where the
+ * shallowest, largest subtrees are. With a scheduler, all items go to the scheduler instead and it picks the next one.
+ */
+class WorkPool {
+public:
+    WorkPool(unsigned numWorkers, std::unique_ptr<StateScheduler> scheduler, Profiler* profiler)
+        : deques(numWorkers), scheduler(std::move(scheduler)), profiler(profiler), pending(0), queued(0), hungry(0),
+          cancelled(false), interrupted(false) {}
+
+    void push(unsigned worker, WorkItem&& item) {
+        pending++;
+        unsigned numQueued = ++queued;
+        if (profiler != nullptr) {
+            profiler->recordWorklistSize(numQueued);
+        }
+        if (scheduler) {
+            lock_guard<mutex> lock(schedulerMutex);
+            scheduler->push(std::move(item));
+        } else {
+            lock_guard<mutex> lock(deques[worker].dequeMutex);
+            deques[worker].items.push_back(std::move(item));
+        }
+        lock_guard<mutex> lock(waitMutex);
+        workAvailable.notify_one();
+    }
+
+    /// Blocks until an item is available or every item has been finished, in which case it returns false
+    bool take(unsigned worker, WorkItem& item) {
+        while (true) {
+            if (isCancelled()) {
+                return false;
+            }
+            if (tryTake(worker, item)) {
+                return true;
+            }
+            unique_lock<mutex> lock(waitMutex);
+            if (pending == 0) {
+                return false;
+            }
+            hungry++;
+            workAvailable.wait(lock, [this] { return queued > 0 || pending == 0 || cancelled; });
+            hungry--;
+        }
+    }
+
+    /// Marks an item returned by take() as fully explored
+    void finish() {
+        if (--pending == 0) {
+            lock_guard<mutex> lock(waitMutex);
+            workAvailable.notify_all();
+        }
+    }
+
+    bool hasHungryWorkers() const {
+        return hungry.load(memory_order_relaxed) > 0;
+    }
+
+    /// Makes every worker drop what it explores and take() return false, leaving queued items unexplored
+    void cancel() {
+        cancelled = true;
+        lock_guard<mutex> lock(waitMutex);
+        workAvailable.notify_all();
+    }
+
+    /// Cancels because the budget ran out, so the items left unexplored leave the outcome undecided
+    void interrupt() {
+        interrupted = true;
+        cancel();
+    }
+
+    bool isCancelled() const {
+        return cancelled.load(memory_order_relaxed);
+    }
+
+    bool wasInterrupted() const {
+        return interrupted.load();
+    }
+
+private:
+    bool tryTake(unsigned worker, WorkItem& item) {
+        if (scheduler) {
+            lock_guard<mutex> lock(schedulerMutex);
+            if (!scheduler->pop(item)) {
+                return false;
+            }
+            queued--;
+            return true;
+        }
+        for (unsigned i = 0; i < deques.size(); i++) {
+            WorkDeque& victim = deques[(worker + i) % deques.size()];
+            lock_guard<mutex> lock(victim.dequeMutex);
+            if (victim.items.empty()) {
+                continue;
+            }
+            if (i == 0) {
+                item = std::move(victim.items.back());
+                victim.items.pop_back();
+            } else {
+                item = std::move(victim.items.front());
+                victim.items.pop_front();
+            }
+            queued--;
+            return true;
+        }
+        return false;
+    }
+
+    struct WorkDeque {
+        mutex dequeMutex;
+        std::deque<WorkItem> items;
+    };
+
+    std::vector<WorkDeque> deques;
+    std::unique_ptr<StateScheduler> scheduler;
+    Profiler* profiler;
+    mutex schedulerMutex;
+    atomic<unsigned> pending;  ///< Items pushed and not finished yet
+    atomic<unsigned> queued;   ///< Items pushed and not taken yet
+    atomic<unsigned> hungry;   ///< Workers waiting for an item
+    atomic<bool> cancelled;
+    atomic<bool> interrupted;
+    mutex waitMutex;
+    condition_variable workAvailable;
+};
+
+
+typedef std::vector<const ICFGEdge*> EdgeList;
+
+
+/**
+ * One entry of a worker's exploration stack: the node stepped into, the range of its out-edges still to follow, the
+ * symbolic state after encoding it and the handle of the path leading to it. Each frame owns exactly one solver scope.
+ */
+struct ExplorationFrame {
+    const ICFGNode* node;
+    const EdgeList* edges;  ///< Out-edges of node the worker follows, in order
+    unsigned nextEdgeIdx;
+    unsigned endEdgeIdx;
+    SymbolicState state;
+    PathTree::PathID path;
+    PathTree::PathID parentPath;  ///< Path before the step into node, which may have passed calls and merged regions
+
+    ExplorationFrame(const ICFGNode* node, const EdgeList* edges, unsigned firstEdge, unsigned endEdge,
+                     SymbolicState state, PathTree::PathID path, PathTree::PathID parentPath)
+        : node(node), edges(edges), nextEdgeIdx(firstEdge), endEdgeIdx(std::min<size_t>(endEdge, edges->size())),
+          state(std::move(state)), path(path), parentPath(parentPath) {}
+
+    bool hasNextEdge() const {
+        return nextEdgeIdx < endEdgeIdx;
+    }
+};
+
+
+/**
+ * Explores WorkItems taken from the pool with its own Z3 context, incremental solver and path arena. Constraints are
+ * simplified as they are added; with slicing enabled the incremental solver is bypassed and every query only holds
+ * the independent clusters it needs.
+ */
+class PathWorker {
+public:
+    PathWorker(unsigned id, const ICFGNode* root, const std::vector<const ICFGNode*>& targets,
+               const DistanceMap& distances, const ExplorerOptions& options, WorkPool& pool, PathReporter& reporter,
+               std::vector<atomic<bool>>& witnessed, atomic<unsigned>& numWitnessed)
+        : id(id), root(root), targets(targets), distances(distances), options(options), pool(pool),
+          reporter(reporter), witnessed(witnessed), numWitnessed(numWitnessed),
+          scheduled(options.scheduler != StateScheduler::DepthFirst), replaying(false),
+          profile(options.profiler != nullptr ? new Profiler::Counters() : nullptr), s(ctx),
+          clusterSolver(ctx), encoder(ctx, *options.memoryRegions, options.theory),
+          summaries(encoder, options.maxLoopUnroll, options.maxPathDepth, options.maxSummaryPaths,
+                    options.solverLimits, options.budget, *options.summaryTable, profile.get()),
+          merger(encoder, targets, options.maxMergePaths), outcomes(targets.size()) {
+        for (unsigned i = 0; i < targets.size(); i++) {
+            targetIdx.insert(std::make_pair(targets[i], i));
+        }
+    }
+
+    void run() {
+        Profiler::Span span(options.profiler, "worker " + std::to_string(id), id);
+        WorkItem item;
+        while (pool.take(id, item)) {
+            explore(item);
+            pool.finish();
+        }
+    }
+
+    /// Outcomes of the paths to each target, in the order of the targets
+    const std::vector<ExplorationSummary>& getOutcomes() const {
+        return outcomes;
+    }
+
+    const ExploredGraph::EdgeSet& getExploredEdges() const {
+        return exploredEdges;
+    }
+
+    /// Counters and timings of the worker, null when not profiling
+    const Profiler::Counters* getProfile() const {
+        return profile.get();
+    }
+
+private:
+    void explore(const WorkItem& item);
+    const ICFGNode* assertRoot(SymbolicState& state);
+    const EdgeList* getEdges(const ICFGNode* node);
+    const ICFGNode* takeEdge(ExplorationFrame& top, unsigned edgeIdx);
+    const ICFGNode* advance(unsigned edgeIdx);
+    bool reportSteppedTargets(PathTree::PathID topPath, PathTree::PathID succPath);
+    void expandFrame(unsigned numForks);
+    const ICFGNode* stepInto(const ICFGNode* node, SymbolicState& state, PathTree::PathID& path);
+    void leavePath(PathTree::PathID path, PathTree::PathID parentPath);
+    void pushScope();
+    void popScope();
+    void addConstraint(const expr& constraint);
+    check_result solvePath(QueryCache::Model* model);
+    check_result solveBranch();
+    check_result solveCluster(const ConstraintSlicer::Cluster& cluster, QueryCache::Model* model);
+    const expr& getCoreTracker(unsigned constraintIdx);
+    void enterNode(const ICFGNode* node);
+    void leaveNode(const ICFGNode* node);
+    const char* exceededBound(PathTree::PathID path, const ICFGNode* succNode) const;
+    void donate();
+    void reportPath(PathTree::PathID path, unsigned target);
+    void countVerdict(check_result verdict, unsigned target);
+    void reportBoundedPath(PathTree::PathID path, const char* reason);
+    void collectFeasiblePath(const std::vector<NodeID>& path, unsigned target);
+    bool collects(ExploredGraph::Scope scope) const;
+
+    unsigned id;
+    const ICFGNode* root;
+    const std::vector<const ICFGNode*>& targets;
+    std::unordered_map<const ICFGNode*, unsigned> targetIdx;  // Index of every target in targets
+    const DistanceMap& distances;
+    const ExplorerOptions& options;
+    WorkPool& pool;
+    PathReporter& reporter;
+    std::vector<atomic<bool>>& witnessed;  // Whether a feasible path to each target was found, by any worker
+    atomic<unsigned>& numWitnessed;
+    bool scheduled;  // Whether items are expanded up to the next fork for a scheduler instead of explored depth-first
+    bool replaying;  // Set while the prefix of an item is stepped into again
+    std::unique_ptr<Profiler::Counters> profile;  // Merged into options.profiler once the exploration is over
+
+    context ctx;
+    solver s;              // Incremental solver holding the whole path, unused when slicing
+    solver clusterSolver;  // Solver the clusters of a sliced query are checked in one at a time
+    ConstraintEncoder encoder;
+    FunctionSummaries summaries;
+    StateMerger merger;
+    PathTree paths;
+    std::vector<ExplorationFrame> frames;  // FILOList, one solver scope per frame
+    std::vector<unsigned> choices;         // Out-edge index taken at every node from the root to the top frame
+    ConstraintEncoder::ConstraintList constraints;
+    std::vector<SlicedConstraint> pathConstraints;  // Constraints of the path to the top frame
+    ConstraintSlicer slicer;               // Clusters of pathConstraints, only kept when slicing
+    std::vector<unsigned> scopeMarks;     // Size of pathConstraints when each scope was pushed
+    QueryCache::Query assertedHashes;     // Hashes of the first path constraints, computed when a query needs them
+    std::vector<expr> coreTrackers;       // Literal tracking the path constraint at each index, with a query cache
+    std::unordered_map<const ICFGNode*, unsigned> pathOccurrences;  // Times each node appears on the current path
+    std::unordered_map<const ICFGNode*, unsigned> nodeVisits;       // Times each node was stepped into
+    std::unordered_map<const ICFGNode*, EdgeList> edgeLists;         // Out-edges followed from each node
+    std::vector<ExplorationSummary> outcomes;
+    ExploredGraph::EdgeSet exploredEdges;  // Merged into options.exploredGraph once the exploration is over
+};
+
+
+/**
+ * Asserts the constraints of the root. A call used as root is stepped over to its return node like any other call.
+ *
+ * @return  The node the first frame is for
+ */
+const ICFGNode* PathWorker::assertRoot(SymbolicState& state) {
+    constraints.clear();
+    const ICFGNode* rootNode;
+    {
+        Profiler::Timer timer(profile.get(), Profiler::ConstraintBuilding);
+        rootNode = summaries.encodeStep(root, state, constraints, 0);
+    }
+    if (rootNode != root) {
+        enterNode(rootNode);
+    }
+    for (const auto & curr_expr : constraints) {
+        addConstraint(curr_expr);
+    }
+    return rootNode;
+}
+
+
+/**
+ * Extends path with node, or with a call node and its return node, and asserts the constraints they contribute. When
+ * merging states, a branch heading a mergeable region is followed by the join point of the region, and so on as long
+ * as the node stepped into heads another one.
+ *
+ * @return  The node the frame for this step is for
+ */
+const ICFGNode* PathWorker::stepInto(const ICFGNode* node, SymbolicState& state, PathTree::PathID& path) {
+    path = paths.extend(path, node);
+    enterNode(node);
+    constraints.clear();
+    const ICFGNode* steppedNode;
+    {
+        Profiler::Timer timer(profile.get(), Profiler::ConstraintBuilding);
+        steppedNode = summaries.encodeStep(node, state, constraints, paths.getLength(path));
+    }
+    if (steppedNode != node) {
+        path = paths.extend(path, steppedNode);
+        enterNode(steppedNode);
+        if (collects(ExploredGraph::ExploredEdges)) {
+            exploredEdges.insert(ExploredGraph::Edge(node->getId(), steppedNode->getId()));
+        }
+    }
+    while (options.mergeStates) {
+        const ICFGNode* join = merger.getJoin(steppedNode);
+        if (join == nullptr) {
+            break;
+        }
+        const ICFGNode* branch = steppedNode;
+        path = paths.extend(path, join);
+        enterNode(join);
+        {
+            Profiler::Timer timer(profile.get(), Profiler::ConstraintBuilding);
+            merger.merge(branch, state, constraints);
+            steppedNode = summaries.encodeStep(join, state, constraints, paths.getLength(path));
+        }
+        if (profile) {
+            profile->count(Profiler::RegionsMerged);
+        }
+        if (collects(ExploredGraph::ExploredEdges)) {
+            exploredEdges.insert(ExploredGraph::Edge(branch->getId(), join->getId()));
+        }
+        if (steppedNode != join) {
+            path = paths.extend(path, steppedNode);
+            enterNode(steppedNode);
+            if (collects(ExploredGraph::ExploredEdges)) {
+                exploredEdges.insert(ExploredGraph::Edge(join->getId(), steppedNode->getId()));
+            }
+        }
+    }
+    for (const auto & curr_expr : constraints) {
+        addConstraint(curr_expr);
+    }
+    return steppedNode;
+}
+
+
+/// Undoes the stepInto() that extended parentPath to path
+void PathWorker::leavePath(PathTree::PathID path, PathTree::PathID parentPath) {
+    while (path != parentPath) {
+        PathTree::PathID parent = paths.getParent(path);
+        leaveNode(paths.getLastNode(path));
+        paths.release(path);
+        path = parent;
+    }
+}
+
+
+void PathWorker::pushScope() {
+    if (!options.sliceConstraints) {
+        s.push();
+    }
+    scopeMarks.push_back(pathConstraints.size());
+}
+
+
+void PathWorker::popScope() {
+    if (!options.sliceConstraints) {
+        s.pop();
+    }
+    pathConstraints.erase(pathConstraints.begin() + scopeMarks.back(), pathConstraints.end());
+    scopeMarks.pop_back();
+    if (options.sliceConstraints) {
+        slicer.truncate(pathConstraints.size());
+    }
+    if (assertedHashes.size() > pathConstraints.size()) {
+        assertedHashes.resize(pathConstraints.size());
+    }
+}
+
+
+void PathWorker::addConstraint(const expr& constraint) {
+    pathConstraints.emplace_back(constraint, options.sliceConstraints);
+    if (options.sliceConstraints) {
+        slicer.add(pathConstraints.back());
+    } else if (options.queryCache) {
+        s.add(implies(getCoreTracker(pathConstraints.size() - 1), pathConstraints.back().simplified));
+    } else {
+        s.add(pathConstraints.back().simplified);
+    }
+}
+
+
+/**
+ * Checks the constraints of the whole path, one independent cluster at a time when slicing.
+ *
+ * @param model  Receives the satisfying assignment if not nullptr and the constraints are satisfiable
+ * @return       Satisfiability of the path constraints
+ */
+check_result PathWorker::solvePath(QueryCache::Model* model) {
+    std::vector<ConstraintSlicer::Cluster> clusters;
+    if (options.sliceConstraints) {
+        clusters = slicer.partition();
+    } else {
+        clusters.emplace_back(pathConstraints.size());
+        std::iota(clusters.back().begin(), clusters.back().end(), 0);
+    }
+
+    check_result verdict = z3::sat;
+    for (const ConstraintSlicer::Cluster& cluster : clusters) {
+        check_result clusterVerdict = solveCluster(cluster, model);
+        if (clusterVerdict == z3::unsat) {
+            verdict = z3::unsat;
+            break;
+        }
+        if (clusterVerdict == z3::unknown) {
+            verdict = z3::unknown;
+        }
+    }
+    if (verdict != z3::sat && model) {
+        model->clear();
+    }
+    return verdict;
+}
+
+
+/**
+ * Checks whether the path stays satisfiable with the branch condition added last. The rest of the path was already
+ * found satisfiable, so with slicing only the cluster of the branch condition is solved.
+ */
+check_result PathWorker::solveBranch() {
+    if (!options.sliceConstraints) {
+        return solvePath(nullptr);
+    }
+    ConstraintSlicer::Cluster cluster = slicer.slice(pathConstraints.size() - 1);
+    return cluster.empty() ? z3::sat : solveCluster(cluster, nullptr);
+}
+
+
+/**
+ * Checks a set of path constraints, answering from the query cache when possible and recording the outcome in it
+ * otherwise. Without slicing the set is the whole path and the incremental solver already holds it.
+ *
+ * @param cluster  Indices of the constraints in pathConstraints
+ * @param model    Has the satisfying assignment of the cluster appended if not nullptr and the cluster is satisfiable
+ * @return         Satisfiability of the cluster
+ */
+check_result PathWorker::solveCluster(const ConstraintSlicer::Cluster& cluster, QueryCache::Model* model) {
+    QueryCache::Query query;
+    check_result verdict = z3::unknown;
+    if (options.queryCache) {
+        // Only the constraints added since the last query still need their text hashed
+        for (unsigned i = assertedHashes.size(); i < pathConstraints.size(); i++) {
+            assertedHashes.push_back(QueryCache::hashConstraint(pathConstraints[i].simplified));
+        }
+        for (unsigned i : cluster) {
+            query.push_back(assertedHashes[i]);
+        }
+        QueryCache::normalize(query);
+        QueryCache::Model cachedModel;
+        if (options.queryCache->lookup(query, verdict, model ? &cachedModel : nullptr)) {
+            if (profile) {
+                profile->count(Profiler::CacheHits);
+            }
+            if (model) {
+                model->insert(model->end(), cachedModel.begin(), cachedModel.end());
+            }
+            return verdict;
+        }
+        if (profile) {
+            profile->count(Profiler::CacheMisses);
+        }
+    }
+
+    // With a query cache every constraint is asserted behind a tracking literal, so an UNSAT check yields the core
+    // the cache refutes later queries with, without solving the cluster again
+    solver& clusterOrPath = options.sliceConstraints ? clusterSolver : s;
+    expr_vector trackers(ctx);
+    std::unordered_map<unsigned, unsigned> trackerIdx;  // AST id of a tracking literal -> index of its constraint
+    if (options.sliceConstraints) {
+        clusterSolver.push();
+    }
+    for (unsigned i : cluster) {
+        if (options.queryCache) {
+            trackers.push_back(getCoreTracker(i));
+            trackerIdx[trackers.back().id()] = i;
+        }
+        if (options.sliceConstraints) {
+            clusterSolver.add(options.queryCache ? implies(getCoreTracker(i), pathConstraints[i].simplified)
+                                                 : pathConstraints[i].simplified);
+        }
+    }
+    options.solverLimits.apply(clusterOrPath, options.budget);
+    {
+        Profiler::Timer timer(profile.get(), Profiler::Solving);
+        verdict = clusterOrPath.check(trackers);
+    }
+    QueryCache::Model clusterModel;
+    if (verdict == z3::sat && model) {
+        z3::model m = clusterOrPath.get_model();
+        for (unsigned i = 0; i < m.size(); i++) {
+            func_decl v = m[i];
+            string var_name = v.name().str();
+            bool tracker = var_name.compare(0, CORE_TRACKER_PREFIX.size(), CORE_TRACKER_PREFIX) == 0;
+            // Memory arrays and tracking literals are part of the model but not values of the path
+            if (v.arity() > 0 || v.range().is_array() || tracker) {
+                continue;
+            }
+            clusterModel.emplace_back(var_name.substr(1, var_name.size() - 1), formatValue(m.get_const_interp(v)));
+        }
+        model->insert(model->end(), clusterModel.begin(), clusterModel.end());
+    }
+    QueryCache::Query core;
+    if (verdict == z3::unsat && options.queryCache) {
+        expr_vector unsatCore = clusterOrPath.unsat_core();
+        for (unsigned i = 0; i < unsatCore.size(); i++) {
+            core.push_back(assertedHashes[trackerIdx[unsatCore[i].id()]]);
+        }
+        QueryCache::normalize(core);
+    }
+    if (options.sliceConstraints) {
+        clusterSolver.pop();
+    }
+
+    if (options.queryCache) {
+        if (verdict == z3::sat) {
+            options.queryCache->insertSat(query, model ? &clusterModel : nullptr);
+        } else if (verdict == z3::unsat) {
+            options.queryCache->insertUnsat(query, core);
+        }
+    }
+    return verdict;
+}
+
+
+/// Literal the path constraint at constraintIdx is asserted behind when its cluster may need an UNSAT core
+const expr& PathWorker::getCoreTracker(unsigned constraintIdx) {
+    while (coreTrackers.size() <= constraintIdx) {
+        coreTrackers.push_back(ctx.bool_const((CORE_TRACKER_PREFIX + std::to_string(coreTrackers.size())).c_str()));
+    }
+    return coreTrackers[constraintIdx];
+}
+
+
+void PathWorker::enterNode(const ICFGNode* node) {
+    pathOccurrences[node]++;
+    if (profile) {
+        profile->count(replaying ? Profiler::NodesReplayed : Profiler::NodesStepped);
+    }
+    // Under a scheduler every item is replayed, which does not count as a visit; creating it did
+    if (options.maxNodeVisits > 0 && !(scheduled && replaying)) {
+        nodeVisits[node]++;
+    }
+}
+
+
+void PathWorker::leaveNode(const ICFGNode* node) {
+    pathOccurrences[node]--;
+}
+
+
+/**
+ * Returns the name of the bound that stepping from path into succNode would exceed, or nullptr if none.
+ */
+const char* PathWorker::exceededBound(PathTree::PathID path, const ICFGNode* succNode) const {
+    if (options.maxPathDepth > 0 && paths.getLength(path) + 1 > options.maxPathDepth) {
+        return "max-path-depth";
+    }
+    auto occurrences = pathOccurrences.find(succNode);
+    if (occurrences != pathOccurrences.end() && occurrences->second > options.maxLoopUnroll) {
+        return "max-loop-unroll";
+    }
+    if (options.maxNodeVisits > 0) {
+        auto visits = nodeVisits.find(succNode);
+        if (visits != nodeVisits.end() && visits->second >= options.maxNodeVisits) {
+            return "max-node-visits";
+        }
+    }
+    return nullptr;
+}
+
+
+/**
+ * Hands the untaken out-edges of the shallowest frame that has any over to the pool, so that a hungry worker gets the
+ * largest subtree available. The top frame is kept: giving it away whole would leave this worker idle in turn, and the
+ * item would bounce between workers without being explored.
+ */
+void PathWorker::donate() {
+    unsigned prefixLength = choices.size() + 1 - frames.size();
+    for (unsigned i = 0; i + 1 < frames.size(); i++) {
+        ExplorationFrame& frame = frames[i];
+        if (!frame.hasNextEdge()) {
+            continue;
+        }
+        WorkItem item;
+        item.prefix.assign(choices.begin(), choices.begin() + prefixLength + i);
+        item.firstEdge = frame.nextEdgeIdx;
+        item.endEdge = frame.endEdgeIdx;
+        frame.endEdgeIdx = frame.nextEdgeIdx;
+        pool.push(id, std::move(item));
+        return;
+    }
+}
+
+
+/**
+ * The out-edges followed from node, computed once per node. Return edges are dropped, so paths stay in the function of
+ * the root, and so are edges to nodes that cannot reach a target when pruning, since nothing below them would be
+ * reported. With nearest-first ordering the rest are sorted by the distance of their destination to a target.
+ */
+const EdgeList* PathWorker::getEdges(const ICFGNode* node) {
+    auto it = edgeLists.find(node);
+    if (it != edgeLists.end()) {
+        return &it->second;
+    }
+    EdgeList& edges = edgeLists[node];
+    for (const ICFGEdge* edge : node->getOutEdges()) {
+        if (edge->isRetCFGEdge() || (options.pruneUnreachable && !distances.canReach(edge->getDstNode()))) {
+            continue;
+        }
+        edges.push_back(edge);
+    }
+    if (options.nearestFirst) {
+        std::stable_sort(edges.begin(), edges.end(), [this](const ICFGEdge* a, const ICFGEdge* b) {
+            return distances.getDistance(a->getDstNode()) < distances.getDistance(b->getDstNode());
+        });
+    }
+    return &edges;
+}
+
+
+void PathWorker::explore(const WorkItem& item) {
+    // Replay the prefix into the solver scope owned by the first frame
+    SymbolicState state;
+    PathTree::PathID path = PathTree::EmptyPath;
+    replaying = true;
+    pushScope();
+    enterNode(root);
+    const ICFGNode* node = assertRoot(state);
+    PathTree::PathID parentPath = PathTree::EmptyPath;
+    for (unsigned choice : item.prefix) {
+        const ICFGEdge* edge = (*getEdges(node))[choice];
+        expr branchCond(ctx);
+        bool hasCond;
+        {
+            Profiler::Timer timer(profile.get(), Profiler::ConstraintBuilding);
+            hasCond = encoder.encodeEdge(edge, state, branchCond);
+        }
+        if (hasCond) {
+            addConstraint(branchCond);
+        }
+        parentPath = path;
+        node = stepInto(edge->getDstNode(), state, path);
+    }
+    replaying = false;
+    choices = item.prefix;
+    frames.emplace_back(node, getEdges(node), item.firstEdge, item.endEdge, std::move(state), path, parentPath);
+    if (scheduled) {
+        expandFrame(item.numForks);
+    }
+
+    while (!frames.empty()) {
+        if (options.budget != nullptr && options.budget->isExhausted()) {
+            pool.interrupt();
+        }
+        if (pool.isCancelled()) {
+            while (!frames.empty()) {
+                frames.pop_back();
+                popScope();
+            }
+            break;
+        }
+        if (!scheduled && pool.hasHungryWorkers()) {
+            donate();
+        }
+
+        ExplorationFrame& top = frames.back();
+        if (!top.hasNextEdge()) {
+            leavePath(top.path, top.parentPath);
+            frames.pop_back();
+            popScope();
+            if (!frames.empty()) {
+                choices.pop_back();
+            }
+            continue;
+        }
+        advance(top.nextEdgeIdx++);
+    }
+    paths.clear();
+    pathOccurrences.clear();
+}
+
+
+/**
+ * Asserts the condition of an out-edge of top and handles its destination if the path ends there: at an infeasible
+ * branch when pruning, at the target, or at an exceeded bound.
+ *
+ * @return  The destination to step into, with the edge's solver scope and choice left for its frame; nullptr if the
+ *          path ends here, in which case both are undone
+ */
+const ICFGNode* PathWorker::takeEdge(ExplorationFrame& top, unsigned edgeIdx) {
+    const ICFGEdge* edge = (*top.edges)[edgeIdx];
+    const ICFGNode* succNode = edge->getDstNode();
+
+    pushScope();
+    expr branchCond(ctx);
+    bool hasCond;
+    {
+        Profiler::Timer timer(profile.get(), Profiler::ConstraintBuilding);
+        hasCond = encoder.encodeEdge(edge, top.state, branchCond);
+    }
+    if (hasCond) {
+        addConstraint(branchCond);
+        // Every path below an unsatisfiable prefix is unsatisfiable as well
+        if (options.pruneInfeasible && solveBranch() == z3::unsat) {
+            if (profile) {
+                profile->count(Profiler::PathsPruned);
+            }
+            popScope();
+            return nullptr;
+        }
+    }
+
+    choices.push_back(edgeIdx);
+    if (collects(ExploredGraph::ExploredEdges)) {
+        exploredEdges.insert(ExploredGraph::Edge(top.node->getId(), succNode->getId()));
+    }
+    auto reached = targetIdx.find(succNode);
+    if (reached != targetIdx.end()) {
+        reportPath(top.path, reached->second);
+        // A path only goes on past a target towards the other targets
+        if (targets.size() == 1) {
+            choices.pop_back();
+            popScope();
+            return nullptr;
+        }
+    }
+
+    // Loops make the ICFG cyclic, so every path is cut once it exceeds one of the exploration bounds
+    if (const char* bound = exceededBound(top.path, succNode)) {
+        PathTree::PathID cutPath = paths.extend(top.path, succNode);
+        reportBoundedPath(cutPath, bound);
+        paths.release(cutPath);
+        choices.pop_back();
+        popScope();
+        return nullptr;
+    }
+    return succNode;
+}
+
+
+/**
+ * Follows out-edge edgeIdx of the top frame into its destination and pushes the frame of the node stepped into last.
+ *
+ * @return  The destination of the edge, or nullptr if the path ends there or at a target stepped past
+ */
+const ICFGNode* PathWorker::advance(unsigned edgeIdx) {
+    ExplorationFrame& top = frames.back();
+    const ICFGNode* succNode = takeEdge(top, edgeIdx);
+    if (succNode == nullptr) {
+        return nullptr;
+    }
+
+    // The last successor of a node takes its state over, so only forks copy it
+    SymbolicState succState = top.hasNextEdge() ? SymbolicState(top.state) : std::move(top.state);
+    PathTree::PathID topPath = top.path;
+    PathTree::PathID succPath = topPath;
+    const ICFGNode* frameNode = stepInto(succNode, succState, succPath);
+    if (frameNode != succNode && !reportSteppedTargets(topPath, succPath)) {
+        leavePath(succPath, topPath);
+        choices.pop_back();
+        popScope();
+        return nullptr;
+    }
+    const EdgeList* frameEdges = getEdges(frameNode);
+    frames.emplace_back(frameNode, frameEdges, 0, ~0u, std::move(succState), succPath, topPath);  // invalidates top
+    return succNode;
+}
+
+
+/**
+ * Reports the paths to the targets among the nodes a step went through past the destination of its edge, such as
+ * the return node of a call stepped over through its summary. takeEdge() only sees the destination itself.
+ *
+ * @param topPath   Path before the step
+ * @param succPath  Path after the step
+ * @return          False if the path ends at one of them, as it does at the only target
+ */
+bool PathWorker::reportSteppedTargets(PathTree::PathID topPath, PathTree::PathID succPath) {
+    std::vector<PathTree::PathID> stepped;
+    for (PathTree::PathID path = succPath; paths.getParent(path) != topPath; path = paths.getParent(path)) {
+        stepped.push_back(path);
+    }
+    for (auto it = stepped.rbegin(); it != stepped.rend(); ++it) {
+        auto reached = targetIdx.find(paths.getLastNode(*it));
+        if (reached == targetIdx.end()) {
+            continue;
+        }
+        reportPath(paths.getParent(*it), reached->second);
+        if (targets.size() == 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/**
+ * Explores below the replayed frame as long as the path does not fork, and hands every successor of the first fork
+ * back to the pool as a new item. Successors are stepped into before they are handed over, so targets they step past
+ * are reported here. Items thus start after a fork, and the nodes in between are replayed once per item, not once
+ * per node.
+ *
+ * @param numForks  Forks on the prefix of the replayed item
+ */
+void PathWorker::expandFrame(unsigned numForks) {
+    unsigned replayedFrames = frames.size();
+    while (!pool.isCancelled()) {
+        if (options.budget != nullptr && options.budget->isExhausted()) {
+            pool.interrupt();
+            break;
+        }
+        ExplorationFrame& top = frames.back();
+        if (!top.hasNextEdge()) {
+            // The replayed frame itself is left to explore()
+            if (frames.size() == replayedFrames) {
+                break;
+            }
+            leavePath(top.path, top.parentPath);
+            frames.pop_back();
+            popScope();
+            choices.pop_back();
+            continue;
+        }
+        bool fork = top.edges->size() > 1;
+        const ICFGNode* succNode = advance(top.nextEdgeIdx++);
+        if (succNode == nullptr || !fork) {
+            continue;
+        }
+        ExplorationFrame& succFrame = frames.back();
+        WorkItem succItem;
+        succItem.prefix = choices;
+        succItem.node = succNode;
+        succItem.numForks = numForks + 1;
+        pool.push(id, std::move(succItem));
+        leavePath(succFrame.path, succFrame.parentPath);
+        frames.pop_back();
+        choices.pop_back();
+        popScope();
+    }
+}
+
+
+/**
+ * Runs the SMT solver on the constraints currently asserted for a path that reached the target and reports the outcome.
+ *
+ * @param path  Handle of the path, excluding the root and the target
+ */
+void PathWorker::reportPath(PathTree::PathID path, unsigned target) {
+    // Only the verdict is counted when the reporter writes no paths, which spares formatting and model extraction
+    if (!reporter.reportsPaths()) {
+        check_result verdict = solvePath(nullptr);
+        countVerdict(verdict, target);
+        if (verdict == z3::sat && collects(ExploredGraph::FeasiblePaths)) {
+            std::vector<NodeID> nodes;
+            for (const ICFGNode* node : paths.getPath(path)) {
+                nodes.push_back(node->getId());
+            }
+            collectFeasiblePath(nodes, target);
+        }
+        return;
+    }
+
+    PathResult result;
+    result.order = choices;
+    for (const ICFGNode* node : paths.getPath(path)) {
+        result.path.push_back(node->getId());
+    }
+    result.target = targets[target]->getId();
+
+    for (const SlicedConstraint& constraint : pathConstraints) {
+        result.constraints.push_back(constraint.constraint.to_string());
+    }
+
+    result.verdict = solvePath(&result.model);
+    countVerdict(result.verdict, target);
+    if (result.verdict == z3::sat && collects(ExploredGraph::FeasiblePaths)) {
+        collectFeasiblePath(result.path, target);
+    }
+    reporter.report(std::move(result));
+}
+
+
+/// Adds the edges of a satisfiable path, given without its root and target, to the feasible subgraph
+void PathWorker::collectFeasiblePath(const std::vector<NodeID>& path, unsigned target) {
+    std::vector<NodeID> nodes(1, root->getId());
+    nodes.insert(nodes.end(), path.begin(), path.end());
+    nodes.push_back(targets[target]->getId());
+    ExploredGraph::addPath(exploredEdges, nodes);
+}
+
+
+bool PathWorker::collects(ExploredGraph::Scope scope) const {
+    return options.exploredGraph != nullptr && options.exploredGraph->getScope() == scope;
+}
+
+
+void PathWorker::countVerdict(check_result verdict, unsigned target) {
+    if (profile) {
+        profile->count(Profiler::PathsExplored);
+    }
+    ExplorationSummary& summary = outcomes[target];
+    switch (verdict) {
+        case z3::sat:
+            summary.feasiblePaths++;
+            break;
+        case z3::unsat:
+            summary.infeasiblePaths++;
+            break;
+        default:
+            summary.unknownPaths++;
+            // The check may have been cut at the end of the time budget, which interrupts the exploration as well
+            if (options.budget != nullptr && options.budget->isExhausted()) {
+                pool.interrupt();
+            }
+            break;
+    }
+    // The exploration is over once every target has a witness
+    if (verdict == z3::sat && options.stopAtWitness && !witnessed[target].exchange(true)
+            && ++numWitnessed == targets.size()) {
+        pool.cancel();
+    }
+}
+
+
+/**
+ * Reports a path that was cut by an exploration bound before reaching the target.
+ *
+ * @param path    Handle of the path, ending with the node that was not stepped into
+ * @param reason  Name of the exceeded bound
+ */
+void PathWorker::reportBoundedPath(PathTree::PathID path, const char* reason) {
+    // The cut path might have gone on to any target
+    for (ExplorationSummary& summary : outcomes) {
+        summary.boundedPaths++;
+    }
+    if (profile) {
+        profile->count(Profiler::PathsExplored);
+        profile->count(Profiler::PathsBounded);
+    }
+    if (!reporter.reportsPaths()) {
+        return;
+    }
+
+    PathResult result;
+    result.order = choices;
+    for (const ICFGNode* node : paths.getPath(path)) {
+        result.path.push_back(node->getId());
+    }
+    result.boundReason = reason;
+    reporter.report(std::move(result));
+}
+
+} // End anonymous namespace
+
+
+std::vector<ExplorationSummary> PathExplorer::explore(NodeID root, const std::vector<NodeID>& targets) {
+    std::vector<const ICFGNode*> targetNodes;
+    for (NodeID target : targets) {
+        targetNodes.push_back(icfg->getICFGNode(target));
+    }
+
+    if (options.budget != nullptr && options.budget->isExhausted()) {
+        std::vector<ExplorationSummary> outcomes(targets.size());
+        for (ExplorationSummary& outcome : outcomes) {
+            outcome.interruptedBy = options.budget->getReason();
+        }
+        return outcomes;
+    }
+
+    const SVFFunction* fun = icfg->getICFGNode(root)->getFun();
+    Profiler::Span span(options.profiler, fun != nullptr ? fun->getName() : "explore", 0, Profiler::Exploration);
+    unsigned numWorkers = std::max(1u, options.numThreads);
+    WorkPool pool(numWorkers, StateScheduler::create(options.scheduler, options.schedulerSeed), options.profiler);
+    pool.push(0, WorkItem());
+
+    DistanceMap distances(targetNodes);
+    std::vector<atomic<bool>> witnessed(targets.size());
+    atomic<unsigned> numWitnessed(0);
+    std::vector<std::unique_ptr<PathWorker>> workers;
+    for (unsigned i = 0; i < numWorkers; i++) {
+        workers.push_back(std::unique_ptr<PathWorker>(new PathWorker(i, icfg->getICFGNode(root), targetNodes,
+                          distances, options, pool, reporter, witnessed, numWitnessed)));
+    }
+
+    // Results of concurrent workers are sorted back into DFS order before printing
+    reporter.setOrdered(numWorkers > 1);
+    std::vector<thread> threads;
+    for (unsigned i = 1; i < numWorkers; i++) {
+        threads.emplace_back(&PathWorker::run, workers[i].get());
+    }
+    workers[0]->run();
+    for (thread& t : threads) {
+        t.join();
+    }
+    reporter.flush();
+
+    std::vector<ExplorationSummary> outcomes(targets.size());
+    for (const auto& worker : workers) {
+        for (unsigned i = 0; i < targets.size(); i++) {
+            outcomes[i].merge(worker->getOutcomes()[i]);
+        }
+        if (options.exploredGraph != nullptr) {
+            options.exploredGraph->merge(worker->getExploredEdges());
+        }
+        if (options.profiler != nullptr) {
+            options.profiler->merge(*worker->getProfile());
+        }
+    }
+    if (pool.wasInterrupted()) {
+        for (ExplorationSummary& outcome : outcomes) {
+            outcome.interruptedBy = options.budget->getReason();
+        }
+    }
+    return outcomes;
+}
@@ -0,0 +1,112 @@
+//===- PathExplorer.h -- Symbolic exploration of ICFG paths -----------------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+/*
+ * Explores the paths between two ICFG nodes with one or more workers. Every worker owns a Z3 context and solver and
+ * runs an incremental DFS; idle workers steal unexplored sibling subtrees (identified by the out-edge choices leading
+ * to them) from the deques of busy ones and replay their prefix into their own solver. Calls are stepped over through
+ * callee summaries, each built once and shared through a SummaryTable by every worker and exploration using it.
+ */
+
+#ifndef PATHEXPLORER_H_
+#define PATHEXPLORER_H_
+
+#include "ConstraintEncoder.h"
+#include "ExploredGraph.h"
+#include "FunctionSummaries.h"
+#include "PathReporter.h"
+#include "Profiler.h"
+#include "QueryCache.h"
+#include "ResourceLimits.h"
+#include "StateScheduler.h"
+#include <memory>
+
+struct ExplorerOptions {
+    bool pruneInfeasible;      ///< Check the prefix at every conditional branch and drop unsatisfiable subtrees
+    bool sliceConstraints;     ///< Solve independent clusters of constraints separately instead of whole paths
+    bool pruneUnreachable;     ///< Skip edges into nodes from which no target can be reached
+    bool nearestFirst;         ///< Follow the out-edges of a node in order of the distance to the nearest target
+    bool stopAtWitness;        ///< Stop exploring once a feasible path to every target was found
+    bool mergeStates;          ///< Merge the paths of small acyclic regions at the post-dominator of their branch
+    StateScheduler::Strategy scheduler;  ///< Order in which states are explored
+    unsigned schedulerSeed;    ///< Seed of the random path scheduler
+    unsigned numThreads;       ///< Number of workers exploring in parallel
+    unsigned maxLoopUnroll;    ///< Times a node may be re-entered on one path
+    unsigned maxNodeVisits;    ///< Times a worker may step into one node over the whole exploration, 0 for no limit
+    unsigned maxPathDepth;     ///< Nodes a path may contain, 0 for no limit
+    unsigned maxSummaryPaths;  ///< Paths of a callee a summary may hold before calls to it are left unconstrained
+    unsigned maxMergePaths;    ///< Paths a region may have to be merged
+    ConstraintEncoder::Theory theory;  ///< Encoding of integer values
+    SolverLimits solverLimits; ///< Limits of every solver query
+    ResourceBudget* budget;    ///< Budget of the whole run, nullptr for none
+    QueryCache* queryCache;    ///< Answers shared by every solver query, nullptr to always run the solver
+    SummaryTable* summaryTable;  ///< Callee summaries built with these options, nullptr for one table per explorer
+    ExploredGraph* exploredGraph;  ///< Receives the edges explored or on feasible paths, nullptr to not collect them
+    Profiler* profiler;        ///< Receives the counters and timings of every worker, nullptr to not profile
+    const MemoryRegions* memoryRegions;  ///< Regions memory is split into, nullptr to keep all memory in one region
+
+    ExplorerOptions()
+        : pruneInfeasible(false), sliceConstraints(false), pruneUnreachable(true), nearestFirst(false),
+          stopAtWitness(false), mergeStates(false), scheduler(StateScheduler::DepthFirst), schedulerSeed(0),
+          numThreads(1), maxLoopUnroll(2), maxNodeVisits(0), maxPathDepth(0), maxSummaryPaths(64), maxMergePaths(8),
+          theory(ConstraintEncoder::IntegerTheory), budget(nullptr), queryCache(nullptr),
+          summaryTable(nullptr), exploredGraph(nullptr), profiler(nullptr), memoryRegions(nullptr) {}
+};
+
+
+class PathExplorer {
+public:
+    PathExplorer(SVF::ICFG* icfg, const ExplorerOptions& options, PathReporter& reporter)
+        : icfg(icfg), options(options), reporter(reporter) {
+        if (options.memoryRegions == nullptr) {
+            ownRegions.reset(new MemoryRegions(icfg, SVF::PAG::getPAG(), nullptr));
+            this->options.memoryRegions = ownRegions.get();
+        }
+        if (options.summaryTable == nullptr) {
+            ownSummaries.reset(new SummaryTable());
+            this->options.summaryTable = ownSummaries.get();
+        }
+    }
+
+    /// Explores every path from root to target and reports each one
+    ExplorationSummary explore(SVF::NodeID root, SVF::NodeID target) {
+        return explore(root, std::vector<SVF::NodeID>(1, target)).front();
+    }
+
+    /**
+     * Explores the paths from root once for all targets, within the function of root, and reports every path reaching
+     * one of them. With several targets a path goes on past a target it reaches, so it can reach the others as well.
+     * Once the budget is exhausted the exploration stops and every outcome is marked as interrupted.
+     *
+     * @return  Outcomes of the paths to each target, in the order of targets
+     */
+    std::vector<ExplorationSummary> explore(SVF::NodeID root, const std::vector<SVF::NodeID>& targets);
+
+private:
+    SVF::ICFG* icfg;
+    ExplorerOptions options;
+    PathReporter& reporter;
+    std::unique_ptr<MemoryRegions> ownRegions;
+    std::unique_ptr<SummaryTable> ownSummaries;
+};
+
+#endif /* PATHEXPLORER_H_ */
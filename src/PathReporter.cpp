@@ -0,0 +1,435 @@
+//===- PathReporter.cpp -- Collection and printing of explored paths --------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+#include "PathReporter.h"
+#include "JsonString.h"
+#include <algorithm>
+#include <cstdio>
+
+using namespace std;
+
+static const string EQUALS_STRING =
+        "==================================================================================";
+
+namespace {
+
+const char BINARY_MAGIC[] = "SVFX";
+const char BINARY_VERSION = 3;
+
+enum RecordKind {
+    FunctionRecord = 1,
+    PathRecord = 2,
+    ResultRecord = 3,
+    SummaryRecord = 4,
+    SourceRecord = 5,
+    TargetRecord = 6,
+    QueriesRecord = 7
+};
+
+/// Verdict of a path as written by the JSON Lines and binary formats
+const char* verdictName(const PathResult& result) {
+    if (!result.boundReason.empty()) {
+        return "bounded";
+    }
+    switch (result.verdict) {
+        case z3::sat:
+            return "sat";
+        case z3::unsat:
+            return "unsat";
+        default:
+            return "unknown";
+    }
+}
+
+unsigned verdictCode(const PathResult& result) {
+    if (!result.boundReason.empty()) {
+        return 3;
+    }
+    switch (result.verdict) {
+        case z3::unsat:
+            return 0;
+        case z3::sat:
+            return 1;
+        default:
+            return 2;
+    }
+}
+
+/// Answer for a function or query: proven reachable, refuted, or neither
+const char* reachabilityName(const ExplorationSummary& summary) {
+    if (summary.isReachable()) {
+        return "reachable";
+    }
+    return summary.isBounded() ? "unknown" : "unreachable";
+}
+
+
+void writeTextCounts(ostream& out, const ExplorationSummary& summary) {
+    out << "feasible " << summary.feasiblePaths << ", infeasible " << summary.infeasiblePaths << ", unknown "
+        << summary.unknownPaths << ", bounded " << summary.boundedPaths;
+    if (summary.interruptedBy != nullptr) {
+        out << ", interrupted by " << summary.interruptedBy;
+    }
+}
+
+
+void writeJsonCounts(ostream& out, const ExplorationSummary& summary) {
+    out << ",\"feasible\":" << summary.feasiblePaths << ",\"infeasible\":" << summary.infeasiblePaths
+        << ",\"unknown\":" << summary.unknownPaths << ",\"bounded\":" << summary.boundedPaths;
+    if (summary.interruptedBy != nullptr) {
+        out << ",\"interrupted\":\"" << summary.interruptedBy << '"';
+    }
+}
+
+} // End anonymous namespace
+
+
+PathReporter::PathReporter(ostream& out, ostream* constraintsOut, OutputFormat format)
+    : out(out), constraintsOut(constraintsOut), format(format), ordered(false), showTargets(false),
+      recorder(nullptr) {
+    if (format == BinaryOutput) {
+        out.write(BINARY_MAGIC, sizeof(BINARY_MAGIC) - 1);
+        out.put(BINARY_VERSION);
+    }
+}
+
+
+void PathReporter::beginFunction(const string& name) {
+    lock_guard<mutex> lock(resultsMutex);
+    function = name;
+    showTargets = false;
+    switch (format) {
+        case TextOutput:
+            out << "Function: " << name << '\n';
+            break;
+        case JsonLinesOutput:
+            out << "{\"type\":\"function\",\"function\":";
+            writeJsonString(out, name);
+            out << "}\n";
+            break;
+        case BinaryOutput:
+            out.put(FunctionRecord);
+            writeString(name);
+            break;
+        case QuietOutput:
+            break;
+    }
+}
+
+
+void PathReporter::endFunction(const ExplorationSummary& summary) {
+    lock_guard<mutex> lock(resultsMutex);
+    switch (format) {
+        case TextOutput:
+            break;
+        case JsonLinesOutput:
+            out << "{\"type\":\"result\",\"function\":";
+            writeJsonString(out, function);
+            out << ",\"answer\":\"" << reachabilityName(summary) << '"';
+            writeJsonCounts(out, summary);
+            out << "}\n";
+            break;
+        case BinaryOutput:
+            out.put(ResultRecord);
+            writeBinaryCounts(summary);
+            break;
+        case QuietOutput:
+            out << function << ": " << reachabilityName(summary) << " (";
+            writeTextCounts(out, summary);
+            out << ")\n";
+            break;
+    }
+}
+
+
+void PathReporter::reportTotals(unsigned functions, unsigned reachable, unsigned unknown) {
+    lock_guard<mutex> lock(resultsMutex);
+    switch (format) {
+        case TextOutput:
+        case QuietOutput:
+            out << "Analyzed " << functions << " function(s), exit reachable in " << reachable << ", unreachable in "
+                << functions - reachable - unknown << ", unknown in " << unknown << '\n';
+            break;
+        case JsonLinesOutput:
+            out << "{\"type\":\"summary\",\"functions\":" << functions << ",\"reachable\":" << reachable
+                << ",\"unreachable\":" << functions - reachable - unknown << ",\"unknown\":" << unknown << "}\n";
+            break;
+        case BinaryOutput:
+            out.put(SummaryRecord);
+            writeVarint(functions);
+            writeVarint(reachable);
+            writeVarint(functions - reachable - unknown);
+            writeVarint(unknown);
+            break;
+    }
+    out.flush();
+}
+
+
+void PathReporter::beginSource(const string& name) {
+    lock_guard<mutex> lock(resultsMutex);
+    function = name;
+    showTargets = true;
+    switch (format) {
+        case TextOutput:
+            out << "Source: " << name << '\n';
+            break;
+        case JsonLinesOutput:
+            out << "{\"type\":\"source\",\"source\":";
+            writeJsonString(out, name);
+            out << "}\n";
+            break;
+        case BinaryOutput:
+            out.put(SourceRecord);
+            writeString(name);
+            break;
+        case QuietOutput:
+            break;
+    }
+}
+
+
+void PathReporter::reportTarget(const string& name, const ExplorationSummary& summary) {
+    lock_guard<mutex> lock(resultsMutex);
+    switch (format) {
+        case TextOutput:
+        case QuietOutput:
+            out << function << " -> " << name << ": " << reachabilityName(summary) << " (";
+            writeTextCounts(out, summary);
+            out << ")\n";
+            break;
+        case JsonLinesOutput:
+            out << "{\"type\":\"target\",\"source\":";
+            writeJsonString(out, function);
+            out << ",\"target\":";
+            writeJsonString(out, name);
+            out << ",\"answer\":\"" << reachabilityName(summary) << '"';
+            writeJsonCounts(out, summary);
+            out << "}\n";
+            break;
+        case BinaryOutput:
+            out.put(TargetRecord);
+            writeString(name);
+            writeBinaryCounts(summary);
+            break;
+    }
+}
+
+
+void PathReporter::reportQueryTotals(unsigned queries, unsigned reachable, unsigned unknown) {
+    lock_guard<mutex> lock(resultsMutex);
+    switch (format) {
+        case TextOutput:
+        case QuietOutput:
+            out << "Answered " << queries << " query(ies), reachable " << reachable << ", unreachable "
+                << queries - reachable - unknown << ", unknown " << unknown << '\n';
+            break;
+        case JsonLinesOutput:
+            out << "{\"type\":\"queries\",\"queries\":" << queries << ",\"reachable\":" << reachable
+                << ",\"unreachable\":" << queries - reachable - unknown << ",\"unknown\":" << unknown << "}\n";
+            break;
+        case BinaryOutput:
+            out.put(QueriesRecord);
+            writeVarint(queries);
+            writeVarint(reachable);
+            writeVarint(queries - reachable - unknown);
+            writeVarint(unknown);
+            break;
+    }
+    out.flush();
+}
+
+
+void PathReporter::report(PathResult&& result) {
+    lock_guard<mutex> lock(resultsMutex);
+    if (ordered) {
+        pending.push_back(std::move(result));
+    } else {
+        print(result);
+    }
+}
+
+
+void PathReporter::flush() {
+    lock_guard<mutex> lock(resultsMutex);
+    std::sort(pending.begin(), pending.end(), [](const PathResult& a, const PathResult& b) {
+        return a.order < b.order;
+    });
+    for (const PathResult& result : pending) {
+        print(result);
+    }
+    pending.clear();
+}
+
+
+void PathReporter::print(const PathResult& result) {
+    if (recorder != nullptr) {
+        recorder->push_back(result);
+    }
+    if (constraintsOut != nullptr) {
+        for (const string& constraint : result.constraints) {
+            *constraintsOut << constraint << '\n';
+        }
+    }
+    switch (format) {
+        case TextOutput:
+            printText(result);
+            break;
+        case JsonLinesOutput:
+            printJson(result);
+            break;
+        case BinaryOutput:
+            printBinary(result);
+            break;
+        case QuietOutput:
+            break;
+    }
+}
+
+
+void PathReporter::printText(const PathResult& result) {
+    out << "Current Path (in Node ID's): ";
+    for (unsigned i = 0; i < result.path.size(); i++) {
+        out << result.path[i] << (i + 1 < result.path.size() ? " -> " : "");
+    }
+    out << '\n';
+
+    if (!result.boundReason.empty()) {
+        out << "Reachable: Bounded (" << result.boundReason << ")" << '\n';
+        out << EQUALS_STRING << '\n';
+        return;
+    }
+
+    if (showTargets) {
+        out << "Target Node: " << result.target << '\n';
+    }
+    out << "Constraints:" << '\n';
+    for (const string& constraint : result.constraints) {
+        out << constraint << '\n';
+    }
+
+    out << "Reachable: ";
+    switch (result.verdict) {
+        case z3::sat: {
+            out << "Yes" << '\n';
+            out << "Satisfiability Values (Variable Name = Value):" << '\n';
+            for (const auto& assignment : result.model) {
+                out << assignment.first << " = " << assignment.second << '\n';
+            }
+            break;
+        }
+        case z3::unsat: {
+            out << "No" << '\n';
+            break;
+        }
+        default: {
+            out << "Unsure" << '\n';
+            break;
+        }
+    }
+    out << EQUALS_STRING << '\n';
+}
+
+
+void PathReporter::printJson(const PathResult& result) {
+    out << "{\"type\":\"path\",\"function\":";
+    writeJsonString(out, function);
+    out << ",\"branches\":[";
+    for (unsigned i = 0; i < result.order.size(); i++) {
+        out << (i > 0 ? "," : "") << result.order[i];
+    }
+    out << "],\"nodes\":[";
+    for (unsigned i = 0; i < result.path.size(); i++) {
+        out << (i > 0 ? "," : "") << result.path[i];
+    }
+    out << ']';
+    if (result.boundReason.empty()) {
+        out << ",\"target\":" << result.target;
+    }
+    out << ",\"verdict\":\"" << verdictName(result) << '"';
+    if (!result.boundReason.empty()) {
+        out << ",\"bound\":";
+        writeJsonString(out, result.boundReason);
+    }
+    out << ",\"constraints\":[";
+    for (unsigned i = 0; i < result.constraints.size(); i++) {
+        out << (i > 0 ? "," : "");
+        writeJsonString(out, result.constraints[i]);
+    }
+    out << "],\"model\":{";
+    for (unsigned i = 0; i < result.model.size(); i++) {
+        out << (i > 0 ? "," : "");
+        writeJsonString(out, result.model[i].first);
+        out << ':';
+        writeJsonString(out, result.model[i].second);
+    }
+    out << "}}\n";
+}
+
+
+void PathReporter::printBinary(const PathResult& result) {
+    out.put(PathRecord);
+    writeVarint(result.order.size());
+    for (unsigned choice : result.order) {
+        writeVarint(choice);
+    }
+    writeVarint(result.path.size());
+    for (SVF::NodeID node : result.path) {
+        writeVarint(node);
+    }
+    writeVarint(result.target);
+    writeVarint(verdictCode(result));
+    writeString(result.boundReason);
+    writeVarint(result.constraints.size());
+    for (const string& constraint : result.constraints) {
+        writeString(constraint);
+    }
+    writeVarint(result.model.size());
+    for (const auto& assignment : result.model) {
+        writeString(assignment.first);
+        writeString(assignment.second);
+    }
+}
+
+
+void PathReporter::writeBinaryCounts(const ExplorationSummary& summary) {
+    writeVarint(summary.feasiblePaths);
+    writeVarint(summary.infeasiblePaths);
+    writeVarint(summary.unknownPaths);
+    writeVarint(summary.boundedPaths);
+    writeString(summary.interruptedBy != nullptr ? summary.interruptedBy : "");
+}
+
+
+void PathReporter::writeVarint(uint64_t value) {
+    while (value >= 0x80) {
+        out.put(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.put(static_cast<char>(value));
+}
+
+
+void PathReporter::writeString(const string& value) {
+    writeVarint(value.size());
+    out.write(value.data(), value.size());
+}
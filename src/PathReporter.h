@@ -0,0 +1,182 @@
+//===- PathReporter.h -- Collection and printing of explored paths ----------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+#ifndef PATHREPORTER_H_
+#define PATHREPORTER_H_
+
+#include "Graphs/ICFG.h"
+#include <z3++.h>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// Outcome counts of one exploration, merged over all workers
+struct ExplorationSummary {
+    unsigned feasiblePaths;
+    unsigned infeasiblePaths;
+    unsigned unknownPaths;
+    unsigned boundedPaths;  ///< Paths cut by a loop, visit or depth bound before reaching the target
+    const char* interruptedBy;  ///< Budget that ended the exploration before every path was explored, or nullptr
+
+    ExplorationSummary()
+        : feasiblePaths(0), infeasiblePaths(0), unknownPaths(0), boundedPaths(0), interruptedBy(nullptr) {}
+
+    void merge(const ExplorationSummary& other) {
+        feasiblePaths += other.feasiblePaths;
+        infeasiblePaths += other.infeasiblePaths;
+        unknownPaths += other.unknownPaths;
+        boundedPaths += other.boundedPaths;
+        if (interruptedBy == nullptr) {
+            interruptedBy = other.interruptedBy;
+        }
+    }
+
+    /// Proven reachable: some path is feasible
+    bool isReachable() const {
+        return feasiblePaths > 0;
+    }
+
+    /// Whether unreachability could not be established because some path was cut, undecided or never explored
+    bool isBounded() const {
+        return !isReachable() && (boundedPaths > 0 || unknownPaths > 0 || interruptedBy != nullptr);
+    }
+};
+
+
+/**
+ * Outcome of solving one path that reached the target. Everything is already formatted so a result can be handed
+ * from the worker that produced it to the thread printing it without touching that worker's Z3 context.
+ */
+struct PathResult {
+    std::vector<unsigned> order;        ///< Position of the out-edge taken at every node among those followed from it
+    std::vector<SVF::NodeID> path;      ///< Node IDs of the path, excluding the root and the target
+    SVF::NodeID target;                 ///< Target the path reached, meaningless for bounded paths
+    std::vector<std::string> constraints;
+    z3::check_result verdict;
+    std::vector<std::pair<std::string, std::string>> model;  ///< Variable name = value, when the path is feasible
+    std::string boundReason;            ///< Bound that cut the path before the target, empty if it reached it
+
+    PathResult() : target(0), verdict(z3::unknown) {}
+};
+
+
+/**
+ * Writes PathResults to the output stream, and their constraints to the constraints stream if there is one. When
+ * results are produced by several workers they are buffered and written in DFS order on flush(), so the output does
+ * not depend on thread scheduling. Output goes through the stream's own buffer and is never flushed per line.
+ *
+ * JsonLinesOutput writes one JSON object per line, each with a "type" of "function" (before its paths), "path",
+ * "result" (counts of one function), "summary" (counts of the whole run) or, when answering source to target queries,
+ * "source" (before the paths from one source), "target" (counts of one query) and "queries" (counts of all queries).
+ *
+ * BinaryOutput starts with the magic "SVFX" and a version byte, followed by records of a kind byte and fields encoded
+ * as LEB128 varints, with strings and lists prefixed by their length:
+ *   1 function  name
+ *   2 path      order[] nodes[] target verdict bound constraints[] model[](name value)
+ *   3 result    feasible infeasible unknown bounded interrupted
+ *   4 summary   functions reachable unreachable unknown
+ *   5 source    name
+ *   6 target    name feasible infeasible unknown bounded interrupted
+ *   7 queries   queries reachable unreachable unknown
+ * where verdict is 0 unsat, 1 sat, 2 unknown, 3 bounded and interrupted names the exhausted budget, empty if none.
+ *
+ * Each function or query is answered reachable (a feasible path was found), unreachable (every path was explored and
+ * found infeasible) or unknown (some path was cut by a bound, undecided by the solver or left unexplored).
+ *
+ * QuietOutput writes only the counts of each function or query and of the run, and no path at all.
+ */
+class PathReporter {
+public:
+    enum OutputFormat {
+        TextOutput,
+        JsonLinesOutput,
+        BinaryOutput,
+        QuietOutput
+    };
+
+    /// @param constraintsOut  Receives the constraints of every path reaching the target, one per line; may be null
+    PathReporter(std::ostream& out, std::ostream* constraintsOut, OutputFormat format = TextOutput);
+
+    /// Buffers results until flush() instead of writing them as they arrive
+    void setOrdered(bool ordered) {
+        this->ordered = ordered;
+    }
+
+    /// Also appends every path written from now on to recorded, in the order written; null to stop
+    void setRecorder(std::vector<PathResult>* recorded) {
+        std::lock_guard<std::mutex> lock(resultsMutex);
+        recorder = recorded;
+    }
+
+    /// Whether paths are written at all; if not, workers need not format constraints and models
+    bool reportsPaths() const {
+        return format != QuietOutput;
+    }
+
+    /// Starts the paths of a function
+    void beginFunction(const std::string& name);
+
+    /// Ends the paths of the current function with their counts
+    void endFunction(const ExplorationSummary& summary);
+
+    /// Counts of the whole run, written last
+    void reportTotals(unsigned functions, unsigned reachable, unsigned unknown);
+
+    /// Starts the paths explored from one source towards several targets, which are written with every path
+    void beginSource(const std::string& name);
+
+    /// Counts of the paths from the current source to one of its targets
+    void reportTarget(const std::string& name, const ExplorationSummary& summary);
+
+    /// Counts of all queries, written last
+    void reportQueryTotals(unsigned queries, unsigned reachable, unsigned unknown);
+
+    /// Thread safe
+    void report(PathResult&& result);
+
+    /// Writes buffered results sorted by PathResult::order
+    void flush();
+
+private:
+    void print(const PathResult& result);
+    void printText(const PathResult& result);
+    void printJson(const PathResult& result);
+    void printBinary(const PathResult& result);
+    void writeBinaryCounts(const ExplorationSummary& summary);
+    void writeVarint(uint64_t value);
+    void writeString(const std::string& value);
+
+    std::ostream& out;
+    std::ostream* constraintsOut;
+    OutputFormat format;
+    bool ordered;
+    std::string function;  ///< Function or source the current paths start from
+    bool showTargets;      ///< Whether the current paths may reach different targets
+    std::mutex resultsMutex;
+    std::vector<PathResult> pending;
+    std::vector<PathResult>* recorder;
+};
+
+#endif /* PATHREPORTER_H_ */
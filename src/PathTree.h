@@ -0,0 +1,99 @@
+//===- PathTree.h -- Shared parent-pointer storage of explored paths --------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+#ifndef PATHTREE_H_
+#define PATHTREE_H_
+
+#include "Graphs/ICFG.h"
+#include <vector>
+
+/**
+ * Arena of path segments linked to their parent segment. A path is identified by the handle of its last segment, so
+ * extending a path costs one segment no matter how long it is, and paths sharing a prefix share its segments. The full
+ * node sequence is only rebuilt when a path is reported.
+ */
+class PathTree {
+public:
+    typedef unsigned PathID;
+
+    enum : PathID {
+        EmptyPath = ~0u  ///< Handle of the path with no nodes
+    };
+
+    /// Returns the handle of the path made of parent followed by node
+    PathID extend(PathID parent, const SVF::ICFGNode* node) {
+        segments.push_back(Segment(node, parent, getLength(parent) + 1));
+        return segments.size() - 1;
+    }
+
+    /// Gives back the storage of id if it is the most recently created segment, which is always the case when paths
+    /// are abandoned in depth-first order
+    void release(PathID id) {
+        if (id != EmptyPath && id + 1 == segments.size()) {
+            segments.pop_back();
+        }
+    }
+
+    const SVF::ICFGNode* getLastNode(PathID id) const {
+        return id == EmptyPath ? nullptr : segments[id].node;
+    }
+
+    PathID getParent(PathID id) const {
+        return id == EmptyPath ? EmptyPath : segments[id].parent;
+    }
+
+    unsigned getLength(PathID id) const {
+        return id == EmptyPath ? 0 : segments[id].length;
+    }
+
+    /// Rebuilds the nodes of path id from first to last
+    std::vector<const SVF::ICFGNode*> getPath(PathID id) const {
+        std::vector<const SVF::ICFGNode*> path(getLength(id));
+        for (auto it = path.rbegin(); it != path.rend(); ++it) {
+            *it = segments[id].node;
+            id = segments[id].parent;
+        }
+        return path;
+    }
+
+    unsigned size() const {
+        return segments.size();
+    }
+
+    void clear() {
+        segments.clear();
+    }
+
+private:
+    struct Segment {
+        const SVF::ICFGNode* node;
+        PathID parent;
+        unsigned length;
+
+        Segment(const SVF::ICFGNode* node, PathID parent, unsigned length)
+            : node(node), parent(parent), length(length) {}
+    };
+
+    std::vector<Segment> segments;
+};
+
+#endif /* PATHTREE_H_ */
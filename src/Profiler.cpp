@@ -0,0 +1,218 @@
+//===- Profiler.cpp -- Counters, phase timers and trace events --------------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+#include "Profiler.h"
+#include "JsonString.h"
+#include "ResourceLimits.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+
+using namespace std;
+
+namespace {
+
+const char* const PHASE_NAMES[Profiler::NumPhases] = {
+    "moduleLoad", "symbolTable", "pagBuild", "pointsTo", "exploration", "constraintBuilding", "solving"
+};
+
+const char* const PHASE_LABELS[Profiler::NumPhases] = {
+    "module load", "symbol table", "PAG build", "points-to", "exploration (wall)", "constraint building (all workers)",
+    "solving (all workers)"
+};
+
+const char* const COUNTER_NAMES[Profiler::NumCounters] = {
+    "nodesStepped", "nodesReplayed", "pathsExplored", "pathsBounded", "pathsPruned", "regionsMerged", "solverCalls",
+    "cacheHits", "cacheMisses", "functionsReused"
+};
+
+const char* const COUNTER_LABELS[Profiler::NumCounters] = {
+    "nodes stepped", "nodes replayed", "paths explored", "paths bounded", "paths pruned", "regions merged",
+    "solver calls", "cache hits", "cache misses", "functions reused"
+};
+
+/// Upper bounds of the histogram buckets in microseconds, one decade each
+const uint64_t BUCKET_LIMITS[Profiler::NumBuckets - 1] = {10, 100, 1000, 10000, 100000, 1000000, 10000000};
+
+const char* const BUCKET_LABELS[Profiler::NumBuckets] = {
+    "< 10us", "< 100us", "< 1ms", "< 10ms", "< 100ms", "< 1s", "< 10s", ">= 10s"
+};
+
+
+double toSeconds(uint64_t nanos) {
+    return nanos / 1e9;
+}
+
+
+uint64_t toMicros(Profiler::Clock::duration time) {
+    return chrono::duration_cast<chrono::microseconds>(time).count();
+}
+
+} // End anonymous namespace
+
+
+Profiler::Counters::Counters() {
+    std::fill(counts, counts + NumCounters, 0);
+    std::fill(nanos, nanos + NumPhases, 0);
+    std::fill(solverHistogram, solverHistogram + NumBuckets, 0);
+}
+
+
+void Profiler::Counters::addTime(Phase phase, Clock::duration time) {
+    nanos[phase] += chrono::duration_cast<chrono::nanoseconds>(time).count();
+    if (phase != Solving) {
+        return;
+    }
+    counts[SolverCalls]++;
+    uint64_t micros = toMicros(time);
+    unsigned bucket = 0;
+    while (bucket < NumBuckets - 1 && micros >= BUCKET_LIMITS[bucket]) {
+        bucket++;
+    }
+    solverHistogram[bucket]++;
+}
+
+
+Profiler::Span::Span(Profiler* profiler, const string& name, unsigned thread, Phase phase)
+    : profiler(profiler), name(name), thread(thread), phase(phase) {
+    if (profiler != nullptr) {
+        start = Clock::now();
+    }
+}
+
+
+Profiler::Span::~Span() {
+    if (profiler != nullptr) {
+        profiler->addSpan(name, thread, phase, start, Clock::now());
+    }
+}
+
+
+Profiler::Profiler() : created(Clock::now()), peakWorklist(0) {}
+
+
+void Profiler::merge(const Counters& counters) {
+    lock_guard<mutex> lock(profileMutex);
+    for (unsigned i = 0; i < NumCounters; i++) {
+        totals.counts[i] += counters.counts[i];
+    }
+    for (unsigned i = 0; i < NumPhases; i++) {
+        totals.nanos[i] += counters.nanos[i];
+    }
+    for (unsigned i = 0; i < NumBuckets; i++) {
+        totals.solverHistogram[i] += counters.solverHistogram[i];
+    }
+}
+
+
+void Profiler::recordWorklistSize(unsigned size) {
+    unsigned peak = peakWorklist.load(memory_order_relaxed);
+    while (size > peak && !peakWorklist.compare_exchange_weak(peak, size, memory_order_relaxed)) {
+    }
+}
+
+
+void Profiler::addSpan(const string& name, unsigned thread, Phase phase, Clock::time_point start,
+                       Clock::time_point end) {
+    lock_guard<mutex> lock(profileMutex);
+    if (phase != NumPhases) {
+        totals.nanos[phase] += chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+    }
+    events.push_back(TraceEvent{name, thread, start - created, end - start});
+}
+
+
+void Profiler::printSummary(ostream& out) const {
+    lock_guard<mutex> lock(profileMutex);
+    out << "Profile\n";
+    ios::fmtflags flags = out.flags();
+    out << fixed << setprecision(3);
+    for (unsigned i = 0; i < NumPhases; i++) {
+        out << "  " << left << setw(36) << PHASE_LABELS[i] << right << setw(12) << toSeconds(totals.nanos[i])
+            << " s\n";
+    }
+    for (unsigned i = 0; i < NumCounters; i++) {
+        out << "  " << left << setw(36) << COUNTER_LABELS[i] << right << setw(12) << totals.counts[i] << '\n';
+    }
+    out << "  " << left << setw(36) << "peak worklist" << right << setw(12) << peakWorklist.load() << '\n';
+    out << "  " << left << setw(36) << "peak RSS (MiB)" << right << setw(12)
+        << ResourceBudget::getPeakRss() / double(1 << 20) << '\n';
+    if (totals.nanos[Exploration] > 0) {
+        out << "  " << left << setw(36) << "paths per second" << right << setw(12)
+            << totals.counts[PathsExplored] / toSeconds(totals.nanos[Exploration]) << '\n';
+    }
+    out << "  solver time histogram\n";
+    for (unsigned i = 0; i < NumBuckets; i++) {
+        out << "    " << left << setw(34) << BUCKET_LABELS[i] << right << setw(12) << totals.solverHistogram[i]
+            << '\n';
+    }
+    out.flags(flags);
+}
+
+
+bool Profiler::writeJson(const string& fileName) const {
+    ofstream out(fileName);
+    if (!out) {
+        return false;
+    }
+    lock_guard<mutex> lock(profileMutex);
+    out << "{\"phases\":{";
+    for (unsigned i = 0; i < NumPhases; i++) {
+        out << (i > 0 ? "," : "") << '"' << PHASE_NAMES[i] << "\":" << toSeconds(totals.nanos[i]);
+    }
+    out << "},\"counters\":{";
+    for (unsigned i = 0; i < NumCounters; i++) {
+        out << (i > 0 ? "," : "") << '"' << COUNTER_NAMES[i] << "\":" << totals.counts[i];
+    }
+    out << ",\"peakWorklist\":" << peakWorklist.load() << ",\"peakRss\":" << ResourceBudget::getPeakRss() << '}';
+    // Bucket i counts the calls below limits[i] microseconds, the last one those at or above the last limit
+    out << ",\"solverHistogram\":{\"limits\":[";
+    for (unsigned i = 0; i < NumBuckets - 1; i++) {
+        out << (i > 0 ? "," : "") << BUCKET_LIMITS[i];
+    }
+    out << "],\"counts\":[";
+    for (unsigned i = 0; i < NumBuckets; i++) {
+        out << (i > 0 ? "," : "") << totals.solverHistogram[i];
+    }
+    out << "]}}\n";
+    return bool(out);
+}
+
+
+bool Profiler::writeTrace(const string& fileName) const {
+    ofstream out(fileName);
+    if (!out) {
+        return false;
+    }
+    lock_guard<mutex> lock(profileMutex);
+    out << "{\"traceEvents\":[";
+    for (unsigned i = 0; i < events.size(); i++) {
+        const TraceEvent& event = events[i];
+        out << (i > 0 ? ",\n" : "\n") << "{\"name\":";
+        writeJsonString(out, event.name);
+        out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread << ",\"ts\":" << toMicros(event.start)
+            << ",\"dur\":" << toMicros(event.duration) << '}';
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return bool(out);
+}
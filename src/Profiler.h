@@ -0,0 +1,157 @@
+//===- Profiler.h -- Counters, phase timers and trace events ----------------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+/*
+ * Where a run spends its time. Hot paths count into a Counters object owned by their thread, which is merged into the
+ * Profiler when the thread is done, so profiling adds no shared writes per node or solver call. Coarse phases (module
+ * loading, PAG building, the exploration of each function) are also recorded as trace events.
+ */
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class Profiler {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    enum Phase {
+        ModuleLoad,          ///< Reading the LLVM modules
+        SymbolTable,         ///< SVFModule::buildSymbolTableInfo
+        PAGBuild,            ///< PAGBuilder::build, including the ICFG
+        PointsTo,            ///< Andersen's analysis and the memory regions built from it
+        Exploration,         ///< Wall-clock time of PathExplorer::explore
+        ConstraintBuilding,  ///< Encoding nodes and edges, summed over workers; includes building callee summaries
+        Solving,             ///< Solver checks, summed over workers
+        NumPhases
+    };
+
+    enum Counter {
+        NodesStepped,   ///< Nodes stepped into, excluding replayed prefixes
+        NodesReplayed,  ///< Nodes stepped into again to replay the prefix of a work item
+        PathsExplored,  ///< Paths that reached a target or were cut by a bound
+        PathsBounded,   ///< Paths cut by a bound
+        PathsPruned,    ///< Subtrees dropped below an unsatisfiable branch
+        RegionsMerged,  ///< Regions whose paths were merged into one step
+        SolverCalls,
+        CacheHits,
+        CacheMisses,
+        FunctionsReused,  ///< Functions whose saved results were replayed instead of exploring them
+        NumCounters
+    };
+
+    /// Buckets of the solver time histogram, one decade of microseconds each from 10us; the last one is open-ended
+    static const unsigned NumBuckets = 8;
+
+    /// Counts and times of one thread
+    struct Counters {
+        uint64_t counts[NumCounters];
+        uint64_t nanos[NumPhases];
+        uint64_t solverHistogram[NumBuckets];
+
+        Counters();
+
+        void count(Counter counter, uint64_t n = 1) {
+            counts[counter] += n;
+        }
+
+        /// Adds to a phase; time added to Solving is one solver call
+        void addTime(Phase phase, Clock::duration time);
+    };
+
+    /// Times a scope into a Counters object; does nothing if it is null
+    class Timer {
+    public:
+        Timer(Counters* counters, Phase phase) : counters(counters), phase(phase) {
+            if (counters != nullptr) {
+                start = Clock::now();
+            }
+        }
+
+        ~Timer() {
+            if (counters != nullptr) {
+                counters->addTime(phase, Clock::now() - start);
+            }
+        }
+
+    private:
+        Counters* counters;
+        Phase phase;
+        Clock::time_point start;
+    };
+
+    /// Records a scope as a trace event and adds its duration to phase, if given; does nothing without a profiler
+    class Span {
+    public:
+        Span(Profiler* profiler, const std::string& name, unsigned thread = 0, Phase phase = NumPhases);
+        ~Span();
+
+    private:
+        Profiler* profiler;
+        std::string name;
+        unsigned thread;
+        Phase phase;
+        Clock::time_point start;
+    };
+
+    Profiler();
+
+    /// Adds the counts and times of a thread that is done
+    void merge(const Counters& counters);
+
+    /// Thread safe; keeps the largest number of work items queued at once
+    void recordWorklistSize(unsigned size);
+
+    /// Human-readable summary of every phase and counter
+    void printSummary(std::ostream& out) const;
+
+    /// Writes the phases and counters as one JSON object
+    bool writeJson(const std::string& fileName) const;
+
+    /// Writes the recorded spans in the Chrome trace event format (chrome://tracing, Perfetto)
+    bool writeTrace(const std::string& fileName) const;
+
+private:
+    struct TraceEvent {
+        std::string name;
+        unsigned thread;
+        Clock::duration start;  ///< Since the profiler was created
+        Clock::duration duration;
+    };
+
+    void addSpan(const std::string& name, unsigned thread, Phase phase, Clock::time_point start, Clock::time_point end);
+
+    Clock::time_point created;
+    Counters totals;
+    std::vector<TraceEvent> events;
+    std::atomic<unsigned> peakWorklist;
+    mutable std::mutex profileMutex;
+};
+
+#endif /* PROFILER_H_ */
@@ -0,0 +1,312 @@
+//===- QueryCache.cpp -- Solver answers keyed by normalized constraint sets -//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+#include "QueryCache.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+using namespace std;
+
+/// First line of a cache file; bump the version whenever the hashing or the layout changes
+static const string CACHE_FILE_HEADER = "svf-ex-query-cache 2";
+
+namespace {
+
+const QueryCache::ConstraintHash FNV_OFFSET = 14695981039346656037ULL;
+
+/// Folds the bytes of value into an FNV-1a hash
+template<typename T>
+void mix(QueryCache::ConstraintHash& hash, T value) {
+    uint64_t bits = (uint64_t) value;
+    for (unsigned i = 0; i < 8; i++) {
+        hash ^= (bits >> (8 * i)) & 0xff;
+        hash *= 1099511628211ULL;
+    }
+}
+
+void mix(QueryCache::ConstraintHash& hash, const char* text) {
+    for (const char* c = text; *c != '\0'; c++) {
+        hash ^= (unsigned char) *c;
+        hash *= 1099511628211ULL;
+    }
+    mix(hash, 0);  // Keeps ("ab", "c") apart from ("a", "bc")
+}
+
+void mix(QueryCache::ConstraintHash& hash, const z3::sort& sort) {
+    mix(hash, sort.sort_kind());
+    if (sort.is_bv()) {
+        mix(hash, sort.bv_size());
+    } else if (sort.is_array()) {
+        mix(hash, sort.array_domain());
+        mix(hash, sort.array_range());
+    } else if (sort.sort_kind() == Z3_UNINTERPRETED_SORT) {
+        mix(hash, Z3_get_symbol_string(sort.ctx(), Z3_get_sort_name(sort.ctx(), sort)));
+    }
+}
+
+/// Hashes the kind, name, parameters (such as the bounds of an extract) and result sort of a function
+QueryCache::ConstraintHash hashDecl(const z3::func_decl& decl) {
+    Z3_context ctx = decl.ctx();
+    QueryCache::ConstraintHash hash = FNV_OFFSET;
+    mix(hash, decl.decl_kind());
+    mix(hash, Z3_get_symbol_string(ctx, Z3_get_decl_name(ctx, decl)));
+    unsigned numParameters = Z3_get_decl_num_parameters(ctx, decl);
+    for (unsigned i = 0; i < numParameters; i++) {
+        Z3_parameter_kind kind = Z3_get_decl_parameter_kind(ctx, decl, i);
+        mix(hash, kind);
+        if (kind == Z3_PARAMETER_INT) {
+            mix(hash, Z3_get_decl_int_parameter(ctx, decl, i));
+        } else if (kind == Z3_PARAMETER_SYMBOL) {
+            mix(hash, Z3_get_symbol_string(ctx, Z3_get_decl_symbol_parameter(ctx, decl, i)));
+        } else if (kind == Z3_PARAMETER_RATIONAL) {
+            mix(hash, Z3_get_decl_rational_parameter(ctx, decl, i));
+        } else if (kind == Z3_PARAMETER_SORT) {
+            mix(hash, z3::sort(decl.ctx(), Z3_get_decl_sort_parameter(ctx, decl, i)));
+        }
+    }
+    mix(hash, decl.range());
+    return hash;
+}
+
+} // End anonymous namespace
+
+
+QueryCache::ConstraintHash QueryCache::hashConstraint(const z3::expr& constraint) {
+    // Subexpressions are shared within a constraint (memory arrays in particular), so each is hashed once by AST id
+    unordered_map<unsigned, ConstraintHash> exprHashes;
+    unordered_map<unsigned, ConstraintHash> declHashes;
+    vector<z3::expr> stack(1, constraint);
+    while (!stack.empty()) {
+        z3::expr e = stack.back();
+        if (exprHashes.count(e.id())) {
+            stack.pop_back();
+            continue;
+        }
+        ConstraintHash hash = FNV_OFFSET;
+        mix(hash, e.kind());
+        if (e.is_numeral()) {
+            mix(hash, Z3_get_numeral_string(e.ctx(), e));
+            mix(hash, e.get_sort());
+        } else if (e.is_app()) {
+            // Children are hashed first; the node is finished once it is on top of the stack again
+            bool childrenDone = true;
+            for (unsigned i = 0; i < e.num_args(); i++) {
+                if (!exprHashes.count(e.arg(i).id())) {
+                    stack.push_back(e.arg(i));
+                    childrenDone = false;
+                }
+            }
+            if (!childrenDone) {
+                continue;
+            }
+            z3::func_decl decl = e.decl();
+            auto declHash = declHashes.find(decl.id());
+            if (declHash == declHashes.end()) {
+                declHash = declHashes.emplace(decl.id(), hashDecl(decl)).first;
+            }
+            mix(hash, declHash->second);
+            for (unsigned i = 0; i < e.num_args(); i++) {
+                mix(hash, exprHashes[e.arg(i).id()]);
+            }
+        } else {
+            // Quantifiers and bound variables do not occur in path constraints, their text is hashed
+            mix(hash, e.to_string().c_str());
+        }
+        exprHashes[e.id()] = hash;
+        stack.pop_back();
+    }
+    return exprHashes[constraint.id()];
+}
+
+
+void QueryCache::normalize(Query& query) {
+    std::sort(query.begin(), query.end());
+    query.erase(std::unique(query.begin(), query.end()), query.end());
+}
+
+
+size_t QueryCache::QueryHasher::operator()(const Query& query) const {
+    size_t hash = query.size();
+    for (ConstraintHash h : query) {
+        hash ^= h + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+
+
+bool QueryCache::lookup(const Query& query, z3::check_result& verdict, Model* model) {
+    lock_guard<mutex> lock(cacheMutex);
+    auto it = entries.find(query);
+    if (it != entries.end() && (it->second.verdict == z3::unsat || model == nullptr || it->second.hasModel)) {
+        verdict = it->second.verdict;
+        if (model != nullptr && verdict == z3::sat) {
+            *model = it->second.model;
+        }
+        hits++;
+        return true;
+    }
+    if (isSubsumedByCore(query)) {
+        verdict = z3::unsat;
+        hits++;
+        return true;
+    }
+    misses++;
+    return false;
+}
+
+
+void QueryCache::insertSat(const Query& query, const Model* model) {
+    lock_guard<mutex> lock(cacheMutex);
+    Entry& entry = entries[query];
+    entry.verdict = z3::sat;
+    if (model != nullptr) {
+        entry.hasModel = true;
+        entry.model = *model;
+    } else if (entry.model.empty()) {
+        entry.hasModel = false;
+    }
+}
+
+
+void QueryCache::insertUnsat(const Query& query, const Query& core) {
+    lock_guard<mutex> lock(cacheMutex);
+    Entry& entry = entries[query];
+    entry.verdict = z3::unsat;
+    entry.hasModel = false;
+    entry.model.clear();
+    if (!core.empty()) {
+        addCore(core);
+    }
+}
+
+
+bool QueryCache::isSubsumedByCore(const Query& query) const {
+    // Each core is indexed under its smallest hash, so it is examined at most once per query
+    for (ConstraintHash h : query) {
+        auto it = coresBySmallest.find(h);
+        if (it == coresBySmallest.end()) {
+            continue;
+        }
+        for (unsigned coreIdx : it->second) {
+            const Query& core = unsatCores[coreIdx];
+            if (std::includes(query.begin(), query.end(), core.begin(), core.end())) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+
+void QueryCache::addCore(const Query& core) {
+    if (isSubsumedByCore(core)) {
+        return;
+    }
+    coresBySmallest[core.front()].push_back(unsatCores.size());
+    unsatCores.push_back(core);
+}
+
+
+/*
+ * File layout, one record per line:
+ *   sat <n> <hash>... <m>   followed by m lines "<name>\t<value>" (m is -1 when no model was kept)
+ *   unsat <n> <hash>...
+ *   core <n> <hash>...
+ */
+bool QueryCache::save(const string& fileName) const {
+    lock_guard<mutex> lock(cacheMutex);
+    ofstream out(fileName);
+    if (!out) {
+        return false;
+    }
+    out << CACHE_FILE_HEADER << "\n";
+    auto writeQuery = [&out](const char* tag, const Query& query) {
+        out << tag << " " << query.size();
+        for (ConstraintHash h : query) {
+            out << " " << h;
+        }
+    };
+    for (const auto& it : entries) {
+        if (it.second.verdict == z3::sat) {
+            writeQuery("sat", it.first);
+            out << " " << (it.second.hasModel ? (long) it.second.model.size() : -1L) << "\n";
+            for (const auto& assignment : it.second.model) {
+                out << assignment.first << "\t" << assignment.second << "\n";
+            }
+        } else {
+            writeQuery("unsat", it.first);
+            out << "\n";
+        }
+    }
+    for (const Query& core : unsatCores) {
+        writeQuery("core", core);
+        out << "\n";
+    }
+    return (bool) out;
+}
+
+
+bool QueryCache::load(const string& fileName) {
+    ifstream in(fileName);
+    string line;
+    if (!in || !getline(in, line) || line != CACHE_FILE_HEADER) {
+        return false;
+    }
+
+    lock_guard<mutex> lock(cacheMutex);
+    while (getline(in, line)) {
+        istringstream record(line);
+        string tag;
+        size_t size = 0;
+        record >> tag >> size;
+        Query query(size);
+        for (ConstraintHash& h : query) {
+            record >> h;
+        }
+        if (!record) {
+            return false;
+        }
+
+        if (tag == "core") {
+            addCore(query);
+        } else if (tag == "unsat") {
+            Entry& entry = entries[query];
+            entry.verdict = z3::unsat;
+            entry.hasModel = false;
+        } else if (tag == "sat") {
+            long modelSize = -1;
+            record >> modelSize;
+            Entry& entry = entries[query];
+            entry.verdict = z3::sat;
+            entry.hasModel = modelSize >= 0;
+            for (long i = 0; i < modelSize && getline(in, line); i++) {
+                size_t tab = line.find('\t');
+                entry.model.emplace_back(line.substr(0, tab), tab == string::npos ? "" : line.substr(tab + 1));
+            }
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
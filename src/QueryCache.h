@@ -0,0 +1,98 @@
+//===- QueryCache.h -- Solver answers keyed by normalized constraint sets ---//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+/*
+ * A query is the set of constraints asserted for a path, each identified by a 64-bit hash of its expression tree:
+ * the operators, symbol names, numerals and sorts, but no Z3 AST ids. Sorting and deduplicating those hashes gives a
+ * key that does not depend on assertion order, on the Z3 context the constraints were built in, or on the run that
+ * produced them, so answers can be shared between workers and persisted to disk. UNSAT cores are kept separately:
+ * any query containing a known core is UNSAT without solving.
+ */
+
+#ifndef QUERYCACHE_H_
+#define QUERYCACHE_H_
+
+#include <z3++.h>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class QueryCache {
+public:
+    typedef uint64_t ConstraintHash;
+    typedef std::vector<ConstraintHash> Query;  ///< Sorted, duplicate-free constraint hashes
+    typedef std::vector<std::pair<std::string, std::string>> Model;
+
+    QueryCache() : hits(0), misses(0) {}
+
+    /// Hashes the DAG of constraint bottom-up, visiting every shared subexpression once
+    static ConstraintHash hashConstraint(const z3::expr& constraint);
+
+    /// Sorts and deduplicates the hashes of a query
+    static void normalize(Query& query);
+
+    /// Returns true and sets verdict (and model, if requested and known) when the answer to query is cached
+    bool lookup(const Query& query, z3::check_result& verdict, Model* model);
+
+    void insertSat(const Query& query, const Model* model);
+
+    /// Records an UNSAT query together with an UNSAT subset of it (normalized), which may be the query itself
+    void insertUnsat(const Query& query, const Query& core);
+
+    /// Reads entries saved by save(); returns false if the file is missing or was written by another format
+    bool load(const std::string& fileName);
+    bool save(const std::string& fileName) const;
+
+    unsigned getHits() const {
+        return hits;
+    }
+    unsigned getMisses() const {
+        return misses;
+    }
+
+private:
+    struct Entry {
+        z3::check_result verdict;
+        bool hasModel;
+        Model model;
+    };
+
+    struct QueryHasher {
+        size_t operator()(const Query& query) const;
+    };
+
+    bool isSubsumedByCore(const Query& query) const;
+    void addCore(const Query& core);
+
+    std::unordered_map<Query, Entry, QueryHasher> entries;
+    std::vector<Query> unsatCores;
+    std::unordered_map<ConstraintHash, std::vector<unsigned>> coresBySmallest;  ///< Smallest hash -> cores
+    mutable std::mutex cacheMutex;
+    std::atomic<unsigned> hits;
+    std::atomic<unsigned> misses;
+};
+
+#endif /* QUERYCACHE_H_ */
@@ -0,0 +1,131 @@
+//===- ResourceLimits.cpp -- Solver limits and exploration budgets ----------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+#include "ResourceLimits.h"
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <sys/resource.h>
+#include <unistd.h>
+#ifdef __APPLE__
+#include <mach/mach.h>
+#endif
+
+using namespace std;
+
+
+void SolverLimits::apply(z3::solver& s, const ResourceBudget* budget) const {
+    unsigned checkTimeout = timeout;
+    unsigned remaining;
+    if (budget != nullptr && budget->getRemainingMillis(remaining)) {
+        // A timeout of 0 would mean no limit, so a check past the deadline still gets a millisecond
+        remaining = max(remaining, 1u);
+        checkTimeout = timeout > 0 ? min(timeout, remaining) : remaining;
+    }
+    if (checkTimeout == 0 && rlimit == 0) {
+        return;
+    }
+    z3::params p(s.ctx());
+    if (checkTimeout > 0) {
+        p.set("timeout", checkTimeout);
+    }
+    if (rlimit > 0) {
+        p.set("rlimit", rlimit);
+    }
+    s.set(p);
+}
+
+
+ResourceBudget::ResourceBudget(double seconds, size_t rssMB)
+    : deadline(Clock::now() + chrono::duration_cast<Clock::duration>(chrono::duration<double>(seconds))),
+      hasDeadline(seconds > 0), maxRss(rssMB << 20), nextRssCheck(0), reason(nullptr) {}
+
+
+bool ResourceBudget::isExhausted() {
+    if (reason.load(memory_order_relaxed) != nullptr) {
+        return true;
+    }
+    Clock::time_point now = Clock::now();
+    const char* exceeded = nullptr;
+    if (hasDeadline && now >= deadline) {
+        exceeded = "time-budget";
+    } else if (maxRss > 0) {
+        long long ticks = now.time_since_epoch().count();
+        long long next = nextRssCheck.load(memory_order_relaxed);
+        long long interval = chrono::duration_cast<Clock::duration>(chrono::milliseconds(100)).count();
+        // Only the thread moving the next check forward reads /proc
+        if (ticks >= next && nextRssCheck.compare_exchange_strong(next, ticks + interval)
+                && getCurrentRss() > maxRss) {
+            exceeded = "memory-budget";
+        }
+    }
+    if (exceeded == nullptr) {
+        return false;
+    }
+    const char* none = nullptr;
+    reason.compare_exchange_strong(none, exceeded);
+    return true;
+}
+
+
+bool ResourceBudget::getRemainingMillis(unsigned& millis) const {
+    if (!hasDeadline) {
+        return false;
+    }
+    Clock::duration left = deadline - Clock::now();
+    long long leftMillis = chrono::duration_cast<chrono::milliseconds>(left).count();
+    millis = (unsigned) max(0ll, min<long long>(leftMillis, numeric_limits<unsigned>::max()));
+    return true;
+}
+
+
+size_t ResourceBudget::getCurrentRss() {
+#ifdef __APPLE__
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t) &info, &count) != KERN_SUCCESS) {
+        return 0;
+    }
+    return info.resident_size;
+#else
+    ifstream statm("/proc/self/statm");
+    size_t pages = 0;
+    size_t residentPages = 0;
+    if (!(statm >> pages >> residentPages)) {
+        return 0;
+    }
+    return residentPages * sysconf(_SC_PAGESIZE);
+#endif
+}
+
+
+size_t ResourceBudget::getPeakRss() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return usage.ru_maxrss;  // Bytes on macOS
+#else
+    return (size_t) usage.ru_maxrss << 10;  // Kilobytes on Linux
+#endif
+}
@@ -0,0 +1,89 @@
+//===- ResourceLimits.h -- Solver limits and exploration budgets ------------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+#ifndef RESOURCELIMITS_H_
+#define RESOURCELIMITS_H_
+
+#include <z3++.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+class ResourceBudget;
+
+/// Limits of every solver query; a query exceeding one is answered unknown
+struct SolverLimits {
+    unsigned timeout;  ///< Milliseconds per check, 0 for no limit
+    unsigned rlimit;   ///< Z3 resource units per check (roughly proportional to work done), 0 for no limit
+
+    SolverLimits() : timeout(0), rlimit(0) {}
+
+    /**
+     * Sets the limits of the next check of s. Z3 cannot be stopped between the checks of the budget, so the timeout
+     * is cut to the time left of budget, if it has a deadline.
+     *
+     * @param budget  Budget of the run; may be null
+     */
+    void apply(z3::solver& s, const ResourceBudget* budget) const;
+};
+
+
+/**
+ * Wall-clock and resident memory budget of a whole run, shared by every worker. Once exceeded it stays exceeded, and
+ * explorations still running or started later end early with their outcome left undecided.
+ */
+class ResourceBudget {
+public:
+    /**
+     * @param seconds  Wall-clock seconds from construction, 0 for no limit
+     * @param rssMB    Resident set size in MiB, 0 for no limit
+     */
+    ResourceBudget(double seconds, size_t rssMB);
+
+    /// Thread safe; the clock is read on every call, the resident set size at most every 100 milliseconds
+    bool isExhausted();
+
+    /// Sets millis to the milliseconds left until the deadline, 0 once it passed; returns false if there is none
+    bool getRemainingMillis(unsigned& millis) const;
+
+    /// The limit that was exceeded first, or nullptr
+    const char* getReason() const {
+        return reason.load();
+    }
+
+    /// Current resident set size in bytes, 0 where it cannot be read
+    static size_t getCurrentRss();
+
+    /// Largest resident set size of the process so far in bytes, 0 where it cannot be read
+    static size_t getPeakRss();
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    Clock::time_point deadline;
+    bool hasDeadline;
+    size_t maxRss;
+    std::atomic<long long> nextRssCheck;  ///< Clock ticks since the epoch
+    std::atomic<const char*> reason;
+};
+
+#endif /* RESOURCELIMITS_H_ */
@@ -0,0 +1,210 @@
+//===- StateMerger.cpp -- Merging of paths at post-dominator join points ----//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+#include "StateMerger.h"
+#include "llvm/IR/Instructions.h"
+#include <iterator>
+
+using namespace SVF;
+using namespace llvm;
+using namespace z3;
+
+namespace {
+
+/// One path of a region being merged: the node stepped into last, the state after it and the conditions so far
+struct RegionPath {
+    const ICFGNode* node;
+    SymbolicState state;
+    ConstraintEncoder::ConstraintList conditions;
+
+    RegionPath(const ICFGNode* node, SymbolicState state, ConstraintEncoder::ConstraintList conditions)
+        : node(node), state(std::move(state)), conditions(std::move(conditions)) {}
+};
+
+
+expr conjoin(z3::context& ctx, const ConstraintEncoder::ConstraintList& conditions) {
+    if (conditions.size() == 1) {
+        return conditions.front();
+    }
+    expr_vector conjuncts(ctx);
+    for (const expr& condition : conditions) {
+        conjuncts.push_back(condition);
+    }
+    return mk_and(conjuncts);
+}
+
+
+/// Whether node is the first node of joinBlock after its phis, where the paths of a region meet
+bool isJoin(const ICFGNode* node, const BasicBlock* joinBlock) {
+    if (node->getBB() != joinBlock) {
+        return false;
+    }
+    const IntraBlockNode* intraNode = SVFUtil::dyn_cast<IntraBlockNode>(node);
+    return intraNode == nullptr || !SVFUtil::isa<PHINode>(intraNode->getInst());
+}
+
+} // End anonymous namespace
+
+
+const ICFGNode* StateMerger::getJoin(const ICFGNode* branch) {
+    auto it = joins.find(branch);
+    if (it != joins.end()) {
+        return it->second;
+    }
+    const ICFGNode* join = findJoin(branch);
+    joins[branch] = join;
+    return join;
+}
+
+
+/**
+ * The join point of a conditional branch: the first node after the phis of the block that immediately post-dominates
+ * the branch, provided every path up to it only holds plain instructions and there are few enough of them.
+ */
+const ICFGNode* StateMerger::findJoin(const ICFGNode* branch) {
+    const IntraBlockNode* intraNode = SVFUtil::dyn_cast<IntraBlockNode>(branch);
+    if (intraNode == nullptr) {
+        return nullptr;
+    }
+    const Instruction* inst = intraNode->getInst();
+    const BranchInst* br = SVFUtil::dyn_cast<BranchInst>(inst);
+    bool forks = br != nullptr ? br->isConditional() && br->getSuccessor(0) != br->getSuccessor(1)
+                               : SVFUtil::isa<SwitchInst>(inst);
+    if (!forks) {
+        return nullptr;
+    }
+
+    // A block whose paths end in different returns or in unreachable has no immediate post-dominator
+    const DomTreeNode* treeNode = getPostDominators(inst->getFunction()).getNode(inst->getParent());
+    const DomTreeNode* joinNode = treeNode != nullptr ? treeNode->getIDom() : nullptr;
+    const BasicBlock* joinBlock = joinNode != nullptr ? joinNode->getBlock() : nullptr;
+    if (joinBlock == nullptr) {
+        return nullptr;
+    }
+
+    std::unordered_map<const ICFGNode*, unsigned> numPaths;
+    std::unordered_set<const ICFGNode*> onStack;
+    const ICFGNode* join = nullptr;
+    unsigned total = 0;
+    for (const ICFGEdge* edge : branch->getOutEdges()) {
+        if (!countPaths(edge->getDstNode(), joinBlock, numPaths, onStack, join)) {
+            return nullptr;
+        }
+        total += numPaths[edge->getDstNode()];
+        if (total > maxMergePaths) {
+            return nullptr;
+        }
+    }
+    return join;
+}
+
+
+/**
+ * Counts the paths from node to the join point into numPaths, memoized per node.
+ *
+ * @return  False if the region below node cannot be merged: it has a loop, a call, a target or too many paths
+ */
+bool StateMerger::countPaths(const ICFGNode* node, const BasicBlock* joinBlock,
+                             std::unordered_map<const ICFGNode*, unsigned>& numPaths,
+                             std::unordered_set<const ICFGNode*>& onStack, const ICFGNode*& join) {
+    if (numPaths.count(node)) {
+        return true;
+    }
+    if (isJoin(node, joinBlock)) {
+        join = node;
+        numPaths[node] = 1;
+        return !targets.count(node);
+    }
+    if (!SVFUtil::isa<IntraBlockNode>(node) || targets.count(node) || !onStack.insert(node).second) {
+        return false;
+    }
+    unsigned total = 0;
+    for (const ICFGEdge* edge : node->getOutEdges()) {
+        if (!countPaths(edge->getDstNode(), joinBlock, numPaths, onStack, join)) {
+            return false;
+        }
+        total += numPaths[edge->getDstNode()];
+        if (total > maxMergePaths) {
+            return false;
+        }
+    }
+    onStack.erase(node);
+    numPaths[node] = total;
+    return total > 0;
+}
+
+
+void StateMerger::merge(const ICFGNode* branch, SymbolicState& state, ConstraintEncoder::ConstraintList& constraints) {
+    const ICFGNode* join = getJoin(branch);
+    std::vector<SymbolicState> states;
+    std::vector<expr> guards;
+    std::vector<RegionPath> worklist;
+    worklist.emplace_back(branch, state, ConstraintEncoder::ConstraintList());
+    ConstraintEncoder::ConstraintList nodeConstraints;
+    while (!worklist.empty()) {
+        RegionPath path = std::move(worklist.back());
+        worklist.pop_back();
+        for (auto it = path.node->OutEdgeBegin(); it != path.node->OutEdgeEnd(); ++it) {
+            const ICFGEdge* edge = *it;
+            // The last successor takes the state and conditions over, so only forks copy them
+            bool last = std::next(it) == path.node->OutEdgeEnd();
+            SymbolicState succState = last ? std::move(path.state) : SymbolicState(path.state);
+            ConstraintEncoder::ConstraintList conditions = last ? std::move(path.conditions)
+                                                                : ConstraintEncoder::ConstraintList(path.conditions);
+            expr branchCond(ctx);
+            if (encoder.encodeEdge(edge, succState, branchCond)) {
+                conditions.push_back(branchCond);
+            }
+            const ICFGNode* succNode = edge->getDstNode();
+            if (succNode == join) {
+                states.push_back(std::move(succState));
+                guards.push_back(conjoin(ctx, conditions));
+                continue;
+            }
+            nodeConstraints.clear();
+            encoder.encodeNode(succNode, succState, nodeConstraints);
+            conditions.insert(conditions.end(), nodeConstraints.begin(), nodeConstraints.end());
+            worklist.emplace_back(succNode, std::move(succState), std::move(conditions));
+        }
+    }
+
+    expr_vector disjuncts(ctx);
+    for (const expr& guard : guards) {
+        disjuncts.push_back(guard);
+    }
+    // Unless a path of the region constrains more than its branches, one of them is always taken
+    expr reached = guards.size() == 1 ? guards.front() : mk_or(disjuncts);
+    expr simplified = reached.simplify();
+    if (!simplified.is_app() || simplified.decl().decl_kind() != Z3_OP_TRUE) {
+        constraints.push_back(reached);
+    }
+    encoder.mergeStates(states, guards, state);
+}
+
+
+const PostDominatorTree& StateMerger::getPostDominators(const Function* fun) {
+    std::unique_ptr<PostDominatorTree>& tree = postDominators[fun];
+    if (!tree) {
+        tree.reset(new PostDominatorTree(const_cast<Function&>(*fun)));
+    }
+    return *tree;
+}
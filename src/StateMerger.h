@@ -0,0 +1,80 @@
+//===- StateMerger.h -- Merging of paths at post-dominator join points ------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+/*
+ * Veritesting-style merging of the paths between a conditional branch and its immediate post-dominator. Instead of
+ * forking at the branch, every path of the region is encoded on its own and the states reaching the join point are
+ * combined into one: values and memory the paths disagree on become ite expressions over the path conditions, and the
+ * path condition of the merged step is their disjunction. A chain of if/else blocks then yields one path instead of
+ * one per combination of branches.
+ *
+ * Only small acyclic regions made of plain instructions are merged: no calls, loops or targets inside, and at most a
+ * given number of paths from the branch to the join. Every merged path adds an arm to each ite and a disjunct to the
+ * path condition of every later query, so the number of paths is the estimate of what merging costs the solver.
+ */
+
+#ifndef STATEMERGER_H_
+#define STATEMERGER_H_
+
+#include "ConstraintEncoder.h"
+#include "llvm/Analysis/PostDominators.h"
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+class StateMerger {
+public:
+    /**
+     * @param targets        Nodes that must be stepped into one by one, so they are never inside a merged region
+     * @param maxMergePaths  Paths a region may have from its branch to its join point to be merged
+     */
+    StateMerger(ConstraintEncoder& encoder, const std::vector<const SVF::ICFGNode*>& targets, unsigned maxMergePaths)
+        : encoder(encoder), ctx(encoder.getContext()), targets(targets.begin(), targets.end()),
+          maxMergePaths(maxMergePaths) {}
+
+    /// The join point of the region starting at branch if the region can be merged, nullptr otherwise
+    const SVF::ICFGNode* getJoin(const SVF::ICFGNode* branch);
+
+    /**
+     * Encodes every path from branch to its join point, which is left for the caller to step into, and merges their
+     * states into state.
+     *
+     * @param constraints  Has the disjunction of the path conditions of the region appended
+     */
+    void merge(const SVF::ICFGNode* branch, SymbolicState& state, ConstraintEncoder::ConstraintList& constraints);
+
+private:
+    const SVF::ICFGNode* findJoin(const SVF::ICFGNode* branch);
+    bool countPaths(const SVF::ICFGNode* node, const llvm::BasicBlock* joinBlock,
+                    std::unordered_map<const SVF::ICFGNode*, unsigned>& numPaths,
+                    std::unordered_set<const SVF::ICFGNode*>& onStack, const SVF::ICFGNode*& join);
+    const llvm::PostDominatorTree& getPostDominators(const llvm::Function* fun);
+
+    ConstraintEncoder& encoder;
+    z3::context& ctx;
+    std::unordered_set<const SVF::ICFGNode*> targets;
+    unsigned maxMergePaths;
+    std::unordered_map<const SVF::ICFGNode*, const SVF::ICFGNode*> joins;  ///< By branch, nullptr if not mergeable
+    std::unordered_map<const llvm::Function*, std::unique_ptr<llvm::PostDominatorTree>> postDominators;
+};
+
+#endif /* STATEMERGER_H_ */
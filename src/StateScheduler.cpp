@@ -0,0 +1,170 @@
+//===- StateScheduler.cpp -- Order in which pending subtrees are explored ---//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+#include "StateScheduler.h"
+#include <cmath>
+#include <deque>
+#include <map>
+#include <queue>
+
+using namespace SVF;
+
+namespace {
+
+class BreadthFirstScheduler : public StateScheduler {
+public:
+    void push(WorkItem&& item) override {
+        items.push_back(std::move(item));
+    }
+
+    bool pop(WorkItem& item) override {
+        if (items.empty()) {
+            return false;
+        }
+        item = std::move(items.front());
+        items.pop_front();
+        return true;
+    }
+
+private:
+    std::deque<WorkItem> items;
+};
+
+
+/**
+ * Walking the execution tree from the root and taking either branch with equal probability reaches a leaf below d
+ * forks with probability 2^-d. Nodes with a single out-edge leave no choice, so the depth of an item is the number of
+ * forks on its prefix rather than its length. Items are bucketed by depth, a bucket is drawn with its size weighted
+ * that way and an item is drawn uniformly from it.
+ */
+class RandomPathScheduler : public StateScheduler {
+public:
+    explicit RandomPathScheduler(unsigned seed) : rng(seed), numItems(0) {}
+
+    void push(WorkItem&& item) override {
+        unsigned depth = item.numForks;
+        itemsByDepth[depth].push_back(std::move(item));
+        numItems++;
+    }
+
+    bool pop(WorkItem& item) override {
+        if (numItems == 0) {
+            return false;
+        }
+        // Weights are relative to the shallowest bucket so deep trees do not underflow
+        unsigned minDepth = itemsByDepth.begin()->first;
+        std::vector<double> weights;
+        for (const auto& bucket : itemsByDepth) {
+            weights.push_back(bucket.second.size() * std::ldexp(1.0, -(int) std::min(bucket.first - minDepth, 1000u)));
+        }
+        std::discrete_distribution<unsigned> pickBucket(weights.begin(), weights.end());
+        auto bucket = std::next(itemsByDepth.begin(), pickBucket(rng));
+
+        std::vector<WorkItem>& items = bucket->second;
+        std::uniform_int_distribution<size_t> pickItem(0, items.size() - 1);
+        size_t picked = pickItem(rng);
+        std::swap(items[picked], items.back());
+        item = std::move(items.back());
+        items.pop_back();
+        if (items.empty()) {
+            itemsByDepth.erase(bucket);
+        }
+        numItems--;
+        return true;
+    }
+
+private:
+    std::mt19937 rng;
+    std::map<unsigned, std::vector<WorkItem>> itemsByDepth;
+    unsigned numItems;
+};
+
+
+/**
+ * Prefers items whose node was explored least often, so new nodes are reached before known ones are explored again.
+ * Items are kept in a heap under the count of their node when pushed; a popped item whose node has been explored
+ * since is pushed back under the current count.
+ */
+class CoverageGuidedScheduler : public StateScheduler {
+public:
+    CoverageGuidedScheduler() : numPushed(0) {}
+
+    void push(WorkItem&& item) override {
+        unsigned count = getCount(item.node);
+        items.push(Entry{count, numPushed++, std::make_shared<WorkItem>(std::move(item))});
+    }
+
+    bool pop(WorkItem& item) override {
+        while (!items.empty()) {
+            Entry entry = items.top();
+            items.pop();
+            unsigned count = getCount(entry.item->node);
+            if (count > entry.count) {
+                entry.count = count;
+                items.push(entry);
+                continue;
+            }
+            item = std::move(*entry.item);
+            if (item.node != nullptr) {
+                explored[item.node]++;
+            }
+            return true;
+        }
+        return false;
+    }
+
+private:
+    struct Entry {
+        unsigned count;
+        unsigned long order;  ///< Breaks ties first in, first out
+        std::shared_ptr<WorkItem> item;
+
+        bool operator<(const Entry& other) const {
+            return count != other.count ? count > other.count : order > other.order;
+        }
+    };
+
+    unsigned getCount(const ICFGNode* node) const {
+        auto it = explored.find(node);
+        return it == explored.end() ? 0 : it->second;
+    }
+
+    std::priority_queue<Entry> items;
+    std::unordered_map<const ICFGNode*, unsigned> explored;
+    unsigned long numPushed;
+};
+
+} // End anonymous namespace
+
+
+std::unique_ptr<StateScheduler> StateScheduler::create(Strategy strategy, unsigned seed) {
+    switch (strategy) {
+        case BreadthFirst:
+            return std::unique_ptr<StateScheduler>(new BreadthFirstScheduler());
+        case RandomPath:
+            return std::unique_ptr<StateScheduler>(new RandomPathScheduler(seed));
+        case CoverageGuided:
+            return std::unique_ptr<StateScheduler>(new CoverageGuidedScheduler());
+        default:
+            return nullptr;
+    }
+}
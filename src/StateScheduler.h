@@ -0,0 +1,75 @@
+//===- StateScheduler.h -- Order in which pending subtrees are explored -----//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+#ifndef STATESCHEDULER_H_
+#define STATESCHEDULER_H_
+
+#include "Graphs/ICFG.h"
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * A subtree left to explore: the position of the out-edge taken at every node from the root to reach its top node, and
+ * the range of that node's out-edges still to follow. Positions are among the edges a worker follows from a node, in
+ * the order it follows them, which every worker derives the same way.
+ */
+struct WorkItem {
+    std::vector<unsigned> prefix;
+    unsigned firstEdge;
+    unsigned endEdge;
+    const SVF::ICFGNode* node;  ///< Node the prefix leads to before it is stepped into, nullptr for the root
+    unsigned numForks;          ///< Nodes on the prefix with more than one out-edge to follow, set by schedulers only
+
+    WorkItem() : firstEdge(0), endEdge(~0u), node(nullptr), numForks(0) {}
+};
+
+
+/**
+ * Picks the next WorkItem to explore among the pending ones. Depth-first search needs no scheduler: every worker
+ * follows its own stack with an incremental solver and only hands subtrees to idle workers. With a scheduler, a
+ * worker instead replays an item, follows the path up to the next fork and gives every successor of the fork back as
+ * a new item, so the scheduler decides the order of every state with a choice to make. Not thread safe, the work
+ * pool serializes calls.
+ */
+class StateScheduler {
+public:
+    enum Strategy {
+        DepthFirst,
+        BreadthFirst,
+        RandomPath,      ///< A leaf below d forks of the execution tree with probability proportional to 2^-d
+        CoverageGuided   ///< The item whose node was explored least often so far
+    };
+
+    /// The scheduler for strategy, nullptr for DepthFirst
+    static std::unique_ptr<StateScheduler> create(Strategy strategy, unsigned seed);
+
+    virtual ~StateScheduler() {}
+
+    virtual void push(WorkItem&& item) = 0;
+
+    /// Removes the next item into item, returns false if there is none
+    virtual bool pop(WorkItem& item) = 0;
+};
+
+#endif /* STATESCHEDULER_H_ */
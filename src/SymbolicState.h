@@ -0,0 +1,149 @@
+//===- SymbolicState.h -- Symbolic values carried along an explored path ----//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+#ifndef SYMBOLICSTATE_H_
+#define SYMBOLICSTATE_H_
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/Value.h"
+#include <z3++.h>
+#include <vector>
+
+/**
+ * Assigns dense IDs to llvm::Values in order of first use, so symbolic states can address them through plain vectors.
+ * A single index is shared by every state of a traversal.
+ */
+class ValueIndex {
+public:
+    typedef unsigned ValueID;
+
+    ValueID getId(const llvm::Value* v) {
+        auto it = ids.insert(std::make_pair(v, (ValueID) ids.size()));
+        if (it.second) {
+            values.push_back(v);
+        }
+        return it.first->second;
+    }
+
+    const llvm::Value* getValue(ValueID id) const {
+        return values[id];
+    }
+
+    unsigned size() const {
+        return ids.size();
+    }
+
+private:
+    llvm::DenseMap<const llvm::Value*, ValueID> ids;
+    std::vector<const llvm::Value*> values;  ///< ID -> value
+};
+
+
+/**
+ * Symbolic state of a path: the expression bound to every SSA value defined so far, addressed by the ValueIndex ID of
+ * the defining llvm::Value, and the contents of memory. Memory at concrete addresses is held per cell; stores through
+ * symbolic pointers go to an array per memory region and value sort. Reads and updates of values and cells are
+ * constant time; the slot tables only grow up to the largest ID the path has touched.
+ */
+struct SymbolicState {
+    typedef ValueIndex::ValueID ValueID;
+
+    std::vector<z3::expr> exprs;
+    std::vector<unsigned> value_slots;   ///< SSA value ID -> 1 + position of its expression in exprs, 0 if unbound
+    std::vector<unsigned> memory_slots;  ///< cell ID -> 1 + position of the expression last stored to the cell
+    std::vector<unsigned> array_slots;   ///< array ID -> 1 + position of the array a region was last accessed as
+    std::vector<unsigned> region_epochs; ///< region ID -> calls that may have written the region so far
+
+    const llvm::BasicBlock* current_block;   ///< Block of the last node stepped into
+    const llvm::BasicBlock* incoming_block;  ///< Predecessor block current_block was entered from (for phis)
+
+    SymbolicState() : current_block(nullptr), incoming_block(nullptr) {}
+
+    /// Sets e to the expression bound to value id and returns true, or returns false if it is unbound
+    bool lookupValue(ValueID id, z3::expr& e) const {
+        return lookup(value_slots, id, e);
+    }
+    void bindValue(ValueID id, const z3::expr& e) {
+        bind(value_slots, id, e);
+    }
+
+    /// Sets e to the expression last stored to cell id and returns true, or returns false if none was
+    bool lookupMemory(ValueID id, z3::expr& e) const {
+        return lookup(memory_slots, id, e);
+    }
+    void bindMemory(ValueID id, const z3::expr& e) {
+        bind(memory_slots, id, e);
+    }
+    void unbindMemory(ValueID id) {
+        if (id < memory_slots.size()) {
+            memory_slots[id] = 0;
+        }
+    }
+
+    /// Sets e to the array region contents of one sort are held in and returns true, or returns false if the region
+    /// was never accessed through a symbolic pointer
+    bool lookupArray(unsigned id, z3::expr& e) const {
+        return lookup(array_slots, id, e);
+    }
+    void bindArray(unsigned id, const z3::expr& e) {
+        bind(array_slots, id, e);
+    }
+    void unbindArray(unsigned id) {
+        if (id < array_slots.size()) {
+            array_slots[id] = 0;
+        }
+    }
+
+    unsigned getEpoch(unsigned region) const {
+        return region < region_epochs.size() ? region_epochs[region] : 0;
+    }
+    void advanceEpoch(unsigned region) {
+        if (region >= region_epochs.size()) {
+            region_epochs.resize(region + 1, 0);
+        }
+        region_epochs[region]++;
+    }
+
+private:
+    bool lookup(const std::vector<unsigned>& slots, ValueID id, z3::expr& e) const {
+        if (id >= slots.size() || slots[id] == 0) {
+            return false;
+        }
+        e = exprs[slots[id] - 1];
+        return true;
+    }
+
+    void bind(std::vector<unsigned>& slots, ValueID id, const z3::expr& e) {
+        if (id >= slots.size()) {
+            slots.resize(id + 1, 0);
+        }
+        if (slots[id] == 0) {
+            exprs.push_back(e);
+            slots[id] = exprs.size();
+        } else {
+            exprs[slots[id] - 1] = e;
+        }
+    }
+};
+
+#endif /* SYMBOLICSTATE_H_ */
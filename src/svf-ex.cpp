@@ -31,9 +31,19 @@
 #include "WPA/Andersen.h"
 #include "SABER/LeakChecker.h"
 #include "SVF-FE/PAGBuilder.h"
+#include "FunctionResultCache.h"
+#include "MemoryRegions.h"
+#include "PathExplorer.h"
+#include "llvm/IR/DebugInfoMetadata.h"
+#include "llvm/Support/Regex.h"
 #include <z3++.h>
+#include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <unordered_map>
 
 
 using namespace SVF;
@@ -44,634 +54,574 @@ using namespace z3;
 static llvm::cl::opt<std::string> InputFilename(cl::Positional,
         llvm::cl::desc("<input bitcode>"), llvm::cl::init("-"));
 
-int findRootOfFunction(ICFG* icfg, string fun_name);
-int findRoot(ICFG* icfg, const string& function_name);
+static llvm::cl::list<std::string> FunctionNames("functions", llvm::cl::CommaSeparated,
+        llvm::cl::desc("Comma-separated functions to analyze (default: every function with a body)"),
+        llvm::cl::value_desc("name"));
+
+static llvm::cl::opt<std::string> FunctionRegex("function-regex",
+        llvm::cl::desc("Only analyze functions whose name matches this regular expression"),
+        llvm::cl::init(""));
+
+static llvm::cl::opt<bool> PruneInfeasibleBranches("prune-infeasible",
+        llvm::cl::desc("Check feasibility at each conditional branch and drop subtrees whose prefix is unsatisfiable"),
+        llvm::cl::init(false));
+
+static llvm::cl::opt<bool> SliceConstraints("slice-constraints",
+        llvm::cl::desc("Solve independent clusters of path constraints separately, only the branch's own when pruning"),
+        llvm::cl::init(false));
+
+static llvm::cl::opt<bool> PruneUnreachable("prune-unreachable",
+        llvm::cl::desc("Skip subgraphs of the ICFG from which no target can be reached"),
+        llvm::cl::init(true));
+
+static llvm::cl::opt<bool> NearestFirst("nearest-first",
+        llvm::cl::desc("Follow the branch closest to a target first instead of the ICFG edge order"),
+        llvm::cl::init(false));
+
+static llvm::cl::opt<bool> StopAtWitness("stop-at-witness",
+        llvm::cl::desc("Stop exploring once a feasible path to every target was found"),
+        llvm::cl::init(false));
+
+static llvm::cl::opt<bool> MergeStates("merge-states",
+        llvm::cl::desc("Merge the paths between a branch and its post-dominator into one ite-guarded state"),
+        llvm::cl::init(false));
+
+static llvm::cl::opt<unsigned> MaxMergePaths("merge-max-paths",
+        llvm::cl::desc("Paths a region may have from its branch to its join point to be merged"),
+        llvm::cl::init(8));
+
+static llvm::cl::opt<StateScheduler::Strategy> Scheduler("scheduler",
+        llvm::cl::desc("Order in which execution states are explored"),
+        llvm::cl::values(
+            clEnumValN(StateScheduler::DepthFirst, "dfs", "Depth-first with incremental solving (default)"),
+            clEnumValN(StateScheduler::BreadthFirst, "bfs", "Breadth-first, shortest paths first"),
+            clEnumValN(StateScheduler::RandomPath, "random-path", "Random walk down the execution tree"),
+            clEnumValN(StateScheduler::CoverageGuided, "coverage", "States at the least explored nodes first")),
+        llvm::cl::init(StateScheduler::DepthFirst));
+
+static llvm::cl::opt<unsigned> SchedulerSeed("scheduler-seed",
+        llvm::cl::desc("Seed of the random-path scheduler"),
+        llvm::cl::init(0));
+
+static llvm::cl::opt<unsigned> ExploreThreads("explore-threads",
+        llvm::cl::desc("Number of worker threads exploring the paths of a function"),
+        llvm::cl::init(1));
+
+static llvm::cl::opt<unsigned> MaxLoopUnroll("max-loop-unroll",
+        llvm::cl::desc("Times a node may be re-entered on one path before the path is cut as bounded"),
+        llvm::cl::init(2));
+
+static llvm::cl::opt<unsigned> MaxNodeVisits("max-node-visits",
+        llvm::cl::desc("Times a worker may step into the same node while exploring a function (0 for no limit)"),
+        llvm::cl::init(0));
+
+static llvm::cl::opt<unsigned> MaxPathDepth("max-path-depth",
+        llvm::cl::desc("Nodes a path may contain before it is cut as bounded (0 for no limit)"),
+        llvm::cl::init(0));
+
+static llvm::cl::opt<ConstraintEncoder::Theory> Encoding("encoding",
+        llvm::cl::desc("Theory integer values are encoded in"),
+        llvm::cl::values(
+            clEnumValN(ConstraintEncoder::IntegerTheory, "int", "Unbounded integers (signedness and overflow ignored)"),
+            clEnumValN(ConstraintEncoder::BitVectorTheory, "bv", "Bitvectors of the LLVM type width (bit-precise)")),
+        llvm::cl::init(ConstraintEncoder::IntegerTheory));
+
+static llvm::cl::opt<bool> UsePointsTo("points-to",
+        llvm::cl::desc("Split memory into regions by Andersen's points-to sets, one array each (else a single region)"),
+        llvm::cl::init(true));
+
+static llvm::cl::opt<unsigned> MaxSummaryPaths("max-summary-paths",
+        llvm::cl::desc("Paths a callee summary may hold before calls to it are left unconstrained (0 for no limit)"),
+        llvm::cl::init(64));
+
+static llvm::cl::opt<unsigned> SolverTimeout("solver-timeout",
+        llvm::cl::desc("Milliseconds a single solver query may take before it is answered unknown (0 for no limit)"),
+        llvm::cl::init(0));
+
+static llvm::cl::opt<unsigned> SolverRlimit("solver-rlimit",
+        llvm::cl::desc("Z3 resource units a solver query may use before it is answered unknown (0 for no limit)"),
+        llvm::cl::init(0));
+
+static llvm::cl::opt<double> TimeBudget("time-budget",
+        llvm::cl::desc("Seconds the analysis may run before open answers are reported unknown (0 for no limit)"),
+        llvm::cl::init(0));
+
+static llvm::cl::opt<unsigned> MemoryBudget("memory-budget",
+        llvm::cl::desc("Resident MiB the analysis may use before open answers are reported unknown (0 for no limit)"),
+        llvm::cl::init(0));
+
+static llvm::cl::opt<bool> Profile("profile",
+        llvm::cl::desc("Print the time of every phase, the solver time histogram and other counters to stderr"),
+        llvm::cl::init(false));
+
+static llvm::cl::opt<std::string> ProfileJson("profile-json",
+        llvm::cl::desc("Write the phase times and counters to this file as JSON"),
+        llvm::cl::value_desc("file"), llvm::cl::init(""));
+
+static llvm::cl::opt<std::string> ProfileTrace("profile-trace",
+        llvm::cl::desc("Write the phases and the explorations of every worker to this file as Chrome trace events"),
+        llvm::cl::value_desc("file"), llvm::cl::init(""));
+
+static llvm::cl::opt<bool> CacheQueries("cache-queries",
+        llvm::cl::desc("Reuse solver answers for constraint sets seen before and refute supersets of UNSAT cores"),
+        llvm::cl::init(true));
+
+static llvm::cl::opt<std::string> QueryCacheFile("query-cache-file",
+        llvm::cl::desc("Load cached solver answers from this file before the analysis and save them after it"),
+        llvm::cl::value_desc("file"), llvm::cl::init(""));
+
+static llvm::cl::opt<std::string> PointsToCacheFile("points-to-cache",
+        llvm::cl::desc("Reuse the points-to memory regions saved in this file for the same modules, else compute and "
+                       "save them"),
+        llvm::cl::value_desc("file"), llvm::cl::init(""));
+
+static llvm::cl::opt<std::string> IncrementalCache("incremental-cache",
+        llvm::cl::desc("Replay the results saved in this file for functions whose IR and callees did not change, "
+                       "explore the others and save their results"),
+        llvm::cl::value_desc("file"), llvm::cl::init(""));
+
+static llvm::cl::opt<PathReporter::OutputFormat> OutputFormat("output-format",
+        llvm::cl::desc("Format paths and counts are written in"),
+        llvm::cl::values(
+            clEnumValN(PathReporter::TextOutput, "text", "Human-readable report of every path"),
+            clEnumValN(PathReporter::JsonLinesOutput, "jsonl", "One JSON object per path and per function"),
+            clEnumValN(PathReporter::BinaryOutput, "binary", "Compact length-prefixed records, see PathReporter.h"),
+            clEnumValN(PathReporter::QuietOutput, "quiet", "Only the path counts of each function")),
+        llvm::cl::init(PathReporter::TextOutput));
+
+static llvm::cl::opt<std::string> OutputFile("output",
+        llvm::cl::desc("Write the report to this file instead of the standard output"),
+        llvm::cl::value_desc("file"), llvm::cl::init(""));
+
+static llvm::cl::list<std::string> Queries("query",
+        llvm::cl::desc("Reachability query from source to target, each a node ID or file:line (e.g. a.c:9,a.c:20)"),
+        llvm::cl::value_desc("source,target"));
+
+static llvm::cl::opt<std::string> QueryFile("query-file",
+        llvm::cl::desc("Read reachability queries from this file, one source and target per line"),
+        llvm::cl::value_desc("file"), llvm::cl::init(""));
+
+static llvm::cl::opt<bool> DumpICFG("dump-icfg",
+        llvm::cl::desc("Write the whole ICFG to icfg.dot"),
+        llvm::cl::init(false));
+
+static llvm::cl::opt<bool> EmitBitcode("emit-bc",
+        llvm::cl::desc("Write the analyzed modules back to bitcode files ending in .svf.bc"),
+        llvm::cl::init(false));
+
+static llvm::cl::opt<std::string> DumpSubgraph("dump-subgraph",
+        llvm::cl::desc("Write the part of the ICFG selected by -dump-subgraph-scope to this dot file"),
+        llvm::cl::value_desc("file"), llvm::cl::init(""));
+
+static llvm::cl::opt<ExploredGraph::Scope> DumpSubgraphScope("dump-subgraph-scope",
+        llvm::cl::desc("Part of the ICFG written by -dump-subgraph"),
+        llvm::cl::values(
+            clEnumValN(ExploredGraph::ExploredEdges, "explored", "Every edge the exploration stepped along"),
+            clEnumValN(ExploredGraph::FeasiblePaths, "feasible", "Only the edges of satisfiable paths")),
+        llvm::cl::init(ExploredGraph::ExploredEdges));
+
+static llvm::cl::opt<std::string> ConstraintsFile("constraints-file",
+        llvm::cl::desc("Also write the constraints of every path reaching the target to this file, one per line"),
+        llvm::cl::value_desc("file"), llvm::cl::init(""));
 
-ofstream MyFile;
 
-string EQUALS_STRING = "==================================================================================";
-
-
-int findRoot(ICFG* icfg, const string& function_name, const string& point_type){
-    for (int i = 0; i < icfg->getTotalNodeNum(); i++){
-        ICFGNode* iNode = icfg->getICFGNode(i);
-        string nodeString =  iNode->toString();
-        string s1 = "fun: " + function_name;
-        string s2 = point_type;  // can only be either Entry or Exit
-        if (nodeString.find(s1)!= string::npos && nodeString.find(s2) != string::npos){
-            return i;
+/**
+ * Entry and exit ICFG node IDs of every function, indexed by exact function name in one pass over the ICFG so that
+ * later lookups are constant time.
+ */
+class FunctionIndex {
+public:
+    explicit FunctionIndex(ICFG* icfg) {
+        for (ICFG::iterator it = icfg->begin(); it != icfg->end(); ++it) {
+            const ICFGNode* node = it->second;
+            if (SVFUtil::isa<FunEntryBlockNode>(node)) {
+                boundaries[node->getFun()->getName()].entry = node->getId();
+                if (!node->getFun()->isDeclaration()) {
+                    definedFunctions.push_back(node->getFun()->getName());
+                }
+            } else if (SVFUtil::isa<FunExitBlockNode>(node)) {
+                boundaries[node->getFun()->getName()].exit = node->getId();
+            }
         }
     }
-    return -1;
-}
-
-
-bool is_positive_number(const std::string& s) {
-    return !s.empty() && std::find_if(s.begin(),
-                                      s.end(), [](unsigned char c) { return !std::isdigit(c); }) == s.end();
-}
-
 
-bool is_number(const std::string& s)
-{
-    if (s.find('-') == 0) {
-        return is_positive_number(s.substr(1, s.size() - 1));
-    } else {
-        return is_positive_number(s);
+    /// Node ID of the entry of function_name, or -1 if the ICFG has none
+    int getEntry(const string& function_name) const {
+        auto it = boundaries.find(function_name);
+        return it == boundaries.end() ? -1 : it->second.entry;
     }
-}
 
-
-void replace_element_at_idx(std::list<expr>& expr_list, int idx, expr& new_expr) {
-    auto expr_list_it = expr_list.begin();
-    std::advance(expr_list_it, idx);
-    expr_list.erase(expr_list_it);
-    if (expr_list.size() == idx) {
-        expr_list.push_back(new_expr);
-    } else {
-        expr_list_it = expr_list.begin();
-        std::advance(expr_list_it, idx);
-        expr_list.insert(expr_list_it, new_expr);
+    /// Node ID of the exit of function_name, or -1 if the ICFG has none
+    int getExit(const string& function_name) const {
+        auto it = boundaries.find(function_name);
+        return it == boundaries.end() ? -1 : it->second.exit;
     }
-}
-
 
-expr get_element_at_idx(std::list<expr>& expr_list, unsigned long idx) {
-    auto expr_it = expr_list.begin();
-    std::advance(expr_it, idx);
-    return *expr_it;
-}
+    /// Names of the functions that have a body, in ICFG node order
+    const std::vector<string>& getDefinedFunctions() const {
+        return definedFunctions;
+    }
 
+private:
+    struct Boundary {
+        int entry = -1;
+        int exit = -1;
+    };
 
-expr get_expr_for_var(std::map<string, unsigned long>& expr_str_to_idx_map, std::list<expr>& expr_list, string var) {
-    unsigned long idx = expr_str_to_idx_map[var];
-    return get_element_at_idx(expr_list, idx);
-}
+    std::unordered_map<string, Boundary> boundaries;
+    std::vector<string> definedFunctions;
+};
 
 
 /**
- * Accepts a reference to a list of ICFGNode objects, extracts constraints from each node, run an SMT solver on it, and
- * returns whether or not is the path feasible.
+ * Selects the functions to analyze from -functions and -function-regex, defaulting to every function with a body.
  *
- * @param nodeList  Reference to a list of ICFGNode objects
- * @return          Boolean value denoting the feasibility of the path
+ * @param functionIndex  Entry/exit index of the ICFG
+ * @return               Names of the functions to analyze, in the order they should be analyzed
  */
-bool checkPathFeasibility(std::list<const ICFGNode*>& nodeList, std::list<bool>& icmpBranchList) {
-    // TODO: Extract constraints from nodes
-    // TODO: Feed it to SMT solver
-    // TODO: Update output to return based on output of SMT solver
-    context c;
-    std::list<expr> expr_list;
-    std::list<expr> constraints;
-    std::map<string, unsigned long> expr_str_to_idx_map;
-
-    for (const ICFGNode* vNode : nodeList) {
-        SVF::ICFGNode::PAGEdgeList pagEdges = vNode->getPAGEdges();
-        string s1 = vNode->toString();
-
-        //for each PAGEdge in ICFGNode.getPAGEdges()
-        for (const PAGEdge* pagEdge : pagEdges) {
-            const Value *valuea = pagEdge->getValue();
-            const Instruction *valueb = pagEdge->getInst();
-
-//            cout << pagEdge->toString() << endl;
-
-            string opcodeName = valueb->getOpcodeName();
-            string beforeEqualOperand = valuea->getName().begin();
-            string loadOperand = valueb->operand_values().begin()->getName().data();
-            loadOperand = "%" + loadOperand;
-
-//            cout << opcodeName << ": " << beforeEqualOperand << "  " << loadOperand << endl;
-
-            //alloca things
-
-            if (opcodeName.compare("alloca") == 0) {
-                MyFile << "O1 == " << beforeEqualOperand << endl;
-                if (expr_str_to_idx_map.find(beforeEqualOperand) == expr_str_to_idx_map.end()) {
-                    expr_str_to_idx_map[beforeEqualOperand] = expr_list.size();
-                    expr_list.push_back(c.int_const(beforeEqualOperand.c_str()));
-                }
-            }
-
-            if (opcodeName.compare("load") == 0) {
-                int equalsPos = s1.find(" = ");
-                int blankPos = s1.find("   ");
-                string firstVar = s1.substr(blankPos + 3, equalsPos - blankPos - 3);
-                MyFile << firstVar << " = " << loadOperand << endl;
-                if (expr_str_to_idx_map.find(firstVar) == expr_str_to_idx_map.end()) {
-                    expr_str_to_idx_map[firstVar] = expr_list.size();
-                    expr_list.push_back(c.int_const(firstVar.c_str()));
-                }
+std::vector<string> selectFunctions(const FunctionIndex& functionIndex) {
+    std::vector<string> candidates(FunctionNames.begin(), FunctionNames.end());
+    if (candidates.empty()) {
+        candidates = functionIndex.getDefinedFunctions();
+    }
 
-                int loadOperandIdx = expr_str_to_idx_map[loadOperand];
-                auto load_expr_it = expr_list.begin();
-                std::advance(load_expr_it, loadOperandIdx);
-                expr load_expr = *load_expr_it;
+    Regex functionRegex(FunctionRegex);
+    std::vector<string> selected;
+    for (const string& function_name : candidates) {
+        if (!FunctionRegex.empty() && !functionRegex.match(function_name)) {
+            continue;
+        }
+        if (functionIndex.getEntry(function_name) < 0 || functionIndex.getExit(function_name) < 0) {
+            cerr << "Skipping " << function_name << ": no entry/exit node in the ICFG" << endl;
+            continue;
+        }
+        selected.push_back(function_name);
+    }
+    return selected;
+}
 
-                int firstVarIdx = expr_str_to_idx_map[firstVar];
-                auto first_var_it = expr_list.begin();
-                std::advance(first_var_it, firstVarIdx);
-                expr first_var = *first_var_it;
 
-                constraints.push_back(first_var == load_expr);
+/**
+ * ICFG node IDs of source lines, from the debug locations of the instructions, indexed in one pass over the ICFG.
+ */
+class LocationIndex {
+public:
+    explicit LocationIndex(ICFG* icfg) : icfg(icfg) {
+        for (ICFG::iterator it = icfg->begin(); it != icfg->end(); ++it) {
+            const Instruction* inst = nullptr;
+            if (const IntraBlockNode* intraNode = SVFUtil::dyn_cast<IntraBlockNode>(it->second)) {
+                inst = intraNode->getInst();
+            } else if (const CallBlockNode* callNode = SVFUtil::dyn_cast<CallBlockNode>(it->second)) {
+                inst = callNode->getCallSite();
             }
-
-            // add things
-
-            if (opcodeName.compare("add") == 0) {
-
-                if (expr_str_to_idx_map.find(beforeEqualOperand) == expr_str_to_idx_map.end()) {
-                    expr_str_to_idx_map[beforeEqualOperand] = expr_list.size();
-                    expr_list.push_back(c.int_const(beforeEqualOperand.c_str()));
-                }
-
-                int i32Pos = s1.find("i32 ");
-                int commaPos = s1.find(",");
-                string firstVar = s1.substr(i32Pos + 4, commaPos - i32Pos - 4);
-
-                s1.erase(0,commaPos+2);
-                commaPos = s1.find(",");
-                string secondVar = s1.substr(0, commaPos);
-
-                if (!is_number(firstVar)) {
-                    if (!is_number(secondVar)) {
-                        expr first_expr = get_expr_for_var(expr_str_to_idx_map, expr_list, firstVar);
-                        expr second_expr = get_expr_for_var(expr_str_to_idx_map, expr_list, secondVar);
-                        expr added_expr = first_expr + second_expr;
-                        replace_element_at_idx(expr_list, expr_str_to_idx_map[beforeEqualOperand], added_expr);
-                    } else {
-                        expr first_expr = get_expr_for_var(expr_str_to_idx_map, expr_list, firstVar);
-                        expr added_expr = first_expr + stoi(secondVar);
-                        replace_element_at_idx(expr_list, expr_str_to_idx_map[beforeEqualOperand], added_expr);
-                    }
-                } else {
-                    if (!is_number(secondVar)) {
-                        expr second_expr = get_expr_for_var(expr_str_to_idx_map, expr_list, secondVar);
-                        expr added_expr = stoi(firstVar) + second_expr;
-                        replace_element_at_idx(expr_list, expr_str_to_idx_map[beforeEqualOperand], added_expr);
-                    } else {
-                        constraints.push_back(get_expr_for_var(expr_str_to_idx_map, expr_list, beforeEqualOperand) == (stoi(firstVar) + stoi(secondVar)));
-                    }
-                }
+            const DILocation* loc = inst != nullptr ? inst->getDebugLoc().get() : nullptr;
+            if (loc == nullptr) {
+                continue;
             }
-
-            // subtract things
-
-            if (opcodeName.compare("sub") == 0) {
-
-                if (expr_str_to_idx_map.find(beforeEqualOperand) == expr_str_to_idx_map.end()) {
-                    expr_str_to_idx_map[beforeEqualOperand] = expr_list.size();
-                    expr_list.push_back(c.int_const(beforeEqualOperand.c_str()));
-                }
-
-                int i32Pos = s1.find("i32 ");
-                int commaPos = s1.find(",");
-                string firstVar = s1.substr(i32Pos + 4, commaPos - i32Pos - 4);
-
-                s1.erase(0,commaPos+2);
-                commaPos = s1.find(",");
-                string secondVar = s1.substr(0, commaPos);
-
-                if (!is_number(firstVar)) {
-                    if (!is_number(secondVar)) {
-                        expr first_expr = get_expr_for_var(expr_str_to_idx_map, expr_list, firstVar);
-                        expr second_expr = get_expr_for_var(expr_str_to_idx_map, expr_list, secondVar);
-                        expr added_expr = first_expr - second_expr;
-                        replace_element_at_idx(expr_list, expr_str_to_idx_map[beforeEqualOperand], added_expr);
-                    } else {
-                        expr first_expr = get_expr_for_var(expr_str_to_idx_map, expr_list, firstVar);
-                        expr added_expr = first_expr - stoi(secondVar);
-                        replace_element_at_idx(expr_list, expr_str_to_idx_map[beforeEqualOperand], added_expr);
-                    }
-                } else {
-                    if (!is_number(secondVar)) {
-                        expr second_expr = get_expr_for_var(expr_str_to_idx_map, expr_list, secondVar);
-                        expr added_expr = stoi(firstVar) - second_expr;
-                        replace_element_at_idx(expr_list, expr_str_to_idx_map[beforeEqualOperand], added_expr);
-                    } else {
-                        constraints.push_back(get_expr_for_var(expr_str_to_idx_map, expr_list, beforeEqualOperand) == (stoi(firstVar) - stoi(secondVar)));
-                    }
-                }
+            // The first node of a line in ICFG node order stands for the line
+            std::vector<Location>& locations = byLine[loc->getLine()];
+            string file = loc->getFilename().str();
+            if (std::find_if(locations.begin(), locations.end(),
+                             [&file](const Location& location) { return location.file == file; }) == locations.end()) {
+                locations.push_back(Location{file, it->first});
             }
+        }
+    }
 
-            // multiply things
-
-            if (opcodeName.compare("mul") == 0) {
-
-                if (expr_str_to_idx_map.find(beforeEqualOperand) == expr_str_to_idx_map.end()) {
-                    expr_str_to_idx_map[beforeEqualOperand] = expr_list.size();
-                    expr_list.push_back(c.int_const(beforeEqualOperand.c_str()));
-                }
-
-                int i32Pos = s1.find("i32 ");
-                int commaPos = s1.find(",");
-                string firstVar = s1.substr(i32Pos + 4, commaPos - i32Pos - 4);
-
-                s1.erase(0,commaPos+2);
-                commaPos = s1.find(",");
-                string secondVar = s1.substr(0, commaPos);
-
-                if (!is_number(firstVar)) {
-                    if (!is_number(secondVar)) {
-                        expr first_expr = get_expr_for_var(expr_str_to_idx_map, expr_list, firstVar);
-                        expr second_expr = get_expr_for_var(expr_str_to_idx_map, expr_list, secondVar);
-                        expr added_expr = first_expr * second_expr;
-                        replace_element_at_idx(expr_list, expr_str_to_idx_map[beforeEqualOperand], added_expr);
-                    } else {
-                        expr first_expr = get_expr_for_var(expr_str_to_idx_map, expr_list, firstVar);
-                        expr added_expr = first_expr * stoi(secondVar);
-                        replace_element_at_idx(expr_list, expr_str_to_idx_map[beforeEqualOperand], added_expr);
-                    }
-                } else {
-                    if (!is_number(secondVar)) {
-                        expr second_expr = get_expr_for_var(expr_str_to_idx_map, expr_list, secondVar);
-                        expr added_expr = stoi(firstVar) * second_expr;
-                        replace_element_at_idx(expr_list, expr_str_to_idx_map[beforeEqualOperand], added_expr);
-                    } else {
-                        constraints.push_back(get_expr_for_var(expr_str_to_idx_map, expr_list, beforeEqualOperand) == (stoi(firstVar) * stoi(secondVar)));
-                    }
-                }
+    /**
+     * Resolves a node ID, or file:line where file is a suffix of the path recorded in the debug information.
+     *
+     * @return  The node ID, or -1 if spec names no node
+     */
+    int resolve(const string& spec) const {
+        size_t colon = spec.rfind(':');
+        if (colon == string::npos) {
+            unsigned id = 0;
+            if (spec.empty() || spec.find_first_not_of("0123456789") != string::npos
+                    || !to_integer(spec, id) || !icfg->hasICFGNode(id)) {
+                return -1;
             }
-
-            // add things
-
-            if (opcodeName.compare("sdiv") == 0) {
-
-                if (expr_str_to_idx_map.find(beforeEqualOperand) == expr_str_to_idx_map.end()) {
-                    expr_str_to_idx_map[beforeEqualOperand] = expr_list.size();
-                    expr_list.push_back(c.int_const(beforeEqualOperand.c_str()));
-                }
-
-                int i32Pos = s1.find("i32 ");
-                int commaPos = s1.find(",");
-                string firstVar = s1.substr(i32Pos + 4, commaPos - i32Pos - 4);
-
-                s1.erase(0,commaPos+2);
-                commaPos = s1.find(",");
-                string secondVar = s1.substr(0, commaPos);
-
-                if (!is_number(firstVar)) {
-                    if (!is_number(secondVar)) {
-                        expr first_expr = get_expr_for_var(expr_str_to_idx_map, expr_list, firstVar);
-                        expr second_expr = get_expr_for_var(expr_str_to_idx_map, expr_list, secondVar);
-                        expr added_expr = first_expr / second_expr;
-                        replace_element_at_idx(expr_list, expr_str_to_idx_map[beforeEqualOperand], added_expr);
-                    } else {
-                        expr first_expr = get_expr_for_var(expr_str_to_idx_map, expr_list, firstVar);
-                        expr added_expr = first_expr / stoi(secondVar);
-                        replace_element_at_idx(expr_list, expr_str_to_idx_map[beforeEqualOperand], added_expr);
-                    }
-                } else {
-                    if (!is_number(secondVar)) {
-                        expr second_expr = get_expr_for_var(expr_str_to_idx_map, expr_list, secondVar);
-                        expr added_expr = stoi(firstVar) / second_expr;
-                        replace_element_at_idx(expr_list, expr_str_to_idx_map[beforeEqualOperand], added_expr);
-                    } else {
-                        constraints.push_back(get_expr_for_var(expr_str_to_idx_map, expr_list, beforeEqualOperand) == (stoi(firstVar) / stoi(secondVar)));
-                    }
-                }
+            return id;
+        }
+        string file = spec.substr(0, colon);
+        unsigned line = 0;
+        auto locations = to_integer(spec.substr(colon + 1), line) ? byLine.find(line) : byLine.end();
+        if (locations == byLine.end()) {
+            return -1;
+        }
+        for (const Location& location : locations->second) {
+            if (location.file.size() >= file.size()
+                    && location.file.compare(location.file.size() - file.size(), file.size(), file) == 0) {
+                return location.node;
             }
         }
+        return -1;
+    }
 
-        //icmp things
-        int posOfOpcode = s1.find("icmp");
-        //see if icmp is in
-        if (posOfOpcode != string::npos) {
-//                cout << "Ohh well!" << "\n";
-            bool currBranchResult = icmpBranchList.front();
-            icmpBranchList.pop_front();
-//                cout << "Whoo!" << currBranchResult << "\n";
-
-//            cout << "lol" << s1 << "\n";
-            int posOfI32 = s1.find("i32 ");
+private:
+    struct Location {
+        string file;
+        NodeID node;
+    };
 
-            string compareOperator = s1.substr(posOfOpcode + 5,posOfI32-posOfOpcode-6);
-//                cout << compareOperator << endl;
-            string compareSign;
+    static bool to_integer(const string& text, unsigned& value) {
+        std::istringstream in(text);
+        return static_cast<bool>(in >> value) && in.eof();
+    }
 
-            string delimiter = ",";
-            int posOfDelimiter = s1.find(delimiter);
+    ICFG* icfg;
+    std::unordered_map<unsigned, std::vector<Location>> byLine;
+};
 
-            string firstOperand = s1.substr(posOfI32 + 4,posOfDelimiter-posOfI32-4);
-//                cout << firstOperand << endl;
 
-            s1.erase(0,posOfDelimiter+2);
+/// A source to target reachability question, both given as a node ID or file:line
+struct ReachabilityQuery {
+    string source;
+    string target;
+};
 
-            posOfDelimiter = s1.find(delimiter);
-            string secondOperand = s1.substr(0,posOfDelimiter);
-//                cout << secondOperand << endl;
 
-            int firstOperandIdx = expr_str_to_idx_map[firstOperand];
-            auto first_expr_it = expr_list.begin();
-            std::advance(first_expr_it, firstOperandIdx);
-            expr first_expr = *first_expr_it;
+/**
+ * Reads the queries of -query and -query-file. Source and target are separated by a comma or whitespace; empty lines
+ * and lines starting with # are skipped.
+ *
+ * @return  False if the query file could not be read
+ */
+bool readQueries(std::vector<ReachabilityQuery>& queries) {
+    std::vector<string> lines(Queries.begin(), Queries.end());
+    if (!QueryFile.empty()) {
+        ifstream in(QueryFile);
+        if (!in) {
+            return false;
+        }
+        for (string line; std::getline(in, line);) {
+            lines.push_back(line);
+        }
+    }
+    for (string line : lines) {
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::istringstream in(line);
+        ReachabilityQuery query;
+        if (!(in >> query.source) || query.source[0] == '#') {
+            continue;
+        }
+        if (!(in >> query.target)) {
+            cerr << "Skipping query " << line << ": no target" << endl;
+            continue;
+        }
+        queries.push_back(query);
+    }
+    return true;
+}
 
-            expr second_expr = c.int_const("whoo");
-            if (!is_number(secondOperand)) {
-                int secondOperandIdx = expr_str_to_idx_map[secondOperand];
-                auto second_expr_it = expr_list.begin();
-                std::advance(second_expr_it, secondOperandIdx);
-                second_expr = *second_expr_it;
-            }
 
-            if (compareOperator.compare("eq") == 0) {
-                if (!is_number(secondOperand)) {
-                    constraints.push_back(first_expr == second_expr);
-                } else {
-                    constraints.push_back(first_expr == stoi(secondOperand));
-                }
-                compareSign =  "==";
-            } else if (compareOperator.compare("ne") == 0) {
-                if (!is_number(secondOperand)) {
-                    constraints.push_back(first_expr != second_expr);
-                } else {
-                    constraints.push_back(first_expr != stoi(secondOperand));
-                }
-                compareSign =  "!=";
-            }
-            else if (compareOperator.compare("ugt") == 0) {
-                if (!is_number(secondOperand)) {
-                    constraints.push_back(first_expr > second_expr);
-                } else {
-                    constraints.push_back(first_expr > stoi(secondOperand));
-                }
-                compareSign =  ">";
-            }
-            else if (compareOperator.compare("uge") == 0) {
-                if (!is_number(secondOperand)) {
-                    constraints.push_back(first_expr >= second_expr);
-                } else {
-                    constraints.push_back(first_expr >= stoi(secondOperand));
-                }
-                compareSign =  ">=";
-            }
-            else if (compareOperator.compare("ult") == 0) {
-                if (!is_number(secondOperand)) {
-                    constraints.push_back(first_expr < second_expr);
-                } else {
-                    constraints.push_back(first_expr < stoi(secondOperand));
-                }
-                compareSign =  "<";
-            }
-            else if (compareOperator.compare("ule") == 0) {
-                if (!is_number(secondOperand)) {
-                    constraints.push_back(first_expr <= second_expr);
-                } else {
-                    constraints.push_back(first_expr <= stoi(secondOperand));
-                }
-                compareSign =  "<=";
-            }
-            else if (compareOperator.compare("sgt") == 0) {
-                if (!is_number(secondOperand)) {
-                    constraints.push_back(first_expr > second_expr);
-                } else {
-                    constraints.push_back(first_expr > stoi(secondOperand));
-                }
-                compareSign =  ">";
-            }
-            else if (compareOperator.compare("sge") == 0) {
-                if (!is_number(secondOperand)) {
-                    constraints.push_back(first_expr >= second_expr);
-                } else {
-                    constraints.push_back(first_expr >= stoi(secondOperand));
-                }
-                compareSign =  ">=";
-            }
-            else if (compareOperator.compare("slt") == 0) {
-                if (!is_number(secondOperand)) {
-                    constraints.push_back(first_expr < second_expr);
-                } else {
-                    constraints.push_back(first_expr < stoi(secondOperand));
-                }
-                compareSign =  "<";
-            }
-            else if (compareOperator.compare("sle") == 0) {
-                if (!is_number(secondOperand)) {
-                    constraints.push_back(first_expr <= second_expr);
-                } else {
-                    constraints.push_back(first_expr <= stoi(secondOperand));
-                }
-                compareSign = "<=";
-            }
-            else {
-                cout << "Invalid compare operator.";
-                compareSign = "";
+/// FNV-1a hash of the contents of the module files, which a points-to cache must have been saved for
+uint64_t hashModuleFiles(const std::vector<std::string>& moduleNames) {
+    uint64_t hash = 14695981039346656037ULL;
+    char buffer[1 << 16];
+    for (const std::string& moduleName : moduleNames) {
+        ifstream in(moduleName, ios::binary);
+        while (in.read(buffer, sizeof(buffer)) || in.gcount() > 0) {
+            for (std::streamsize i = 0; i < in.gcount(); i++) {
+                hash ^= (unsigned char) buffer[i];
+                hash *= 1099511628211ULL;
             }
-
-            if (!currBranchResult) {
-                expr originalExpr = constraints.back();
-                constraints.pop_back();
-                constraints.push_back(!originalExpr);
-            }
-
-            MyFile << firstOperand << " " << compareSign << " " << secondOperand << endl;
         }
+        // Separates the files, so moving bytes from one module to the next changes the hash
+        hash ^= 0xff;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
 
 
-        // store things
-        posOfOpcode = s1.find("store");
-
-        //see if store is in node
-        if (posOfOpcode != string::npos) {
-
-            int posOfI32 = s1.find("i32 ");
-            int posDelimiter = s1.find(',');
-
-            string secondOperand = s1.substr(posOfI32 + 4,posDelimiter-posOfI32-4); //value that needs to be stored
-            s1.erase(0,posDelimiter+2); //erase node string up to space
+/**
+ * Memory regions from Andersen's points-to sets, or a single region with -points-to=false. With -points-to-cache the
+ * regions are read from the cache if it was saved for the same modules, and computed and saved otherwise. Only the
+ * regions are cached: the PAG and ICFG are still built, as the encoder reads the LLVM instructions of their nodes.
+ */
+std::unique_ptr<MemoryRegions> buildMemoryRegions(const std::vector<std::string>& moduleNames, ICFG* icfg, PAG* pag) {
+    if (!UsePointsTo) {
+        return std::unique_ptr<MemoryRegions>(new MemoryRegions(icfg, pag, nullptr));
+    }
+    uint64_t moduleHash = 0;
+    if (!PointsToCacheFile.empty()) {
+        moduleHash = hashModuleFiles(moduleNames);
+        std::unique_ptr<MemoryRegions> regions = MemoryRegions::load(PointsToCacheFile, moduleHash, icfg);
+        if (regions) {
+            return regions;
+        }
+    }
+    std::unique_ptr<MemoryRegions> regions(new MemoryRegions(icfg, pag,
+                                                             AndersenWaveDiff::createAndersenWaveDiff(pag)));
+    if (!PointsToCacheFile.empty() && !regions->save(PointsToCacheFile, moduleHash)) {
+        cerr << "Could not write the points-to cache to " << PointsToCacheFile << endl;
+    }
+    return regions;
+}
 
-            posDelimiter = s1.find(',');
-            int posSpace = s1.find(' ');
 
-            string firstOperand = s1.substr(posSpace+1,posDelimiter-posSpace-1); //place to store it to
+/// Explorer options taken from the command line
+ExplorerOptions getExplorerOptions(QueryCache* queryCache, ExploredGraph* exploredGraph, ResourceBudget* budget,
+                                   Profiler* profiler) {
+    ExplorerOptions options;
+    options.pruneInfeasible = PruneInfeasibleBranches;
+    options.sliceConstraints = SliceConstraints;
+    options.pruneUnreachable = PruneUnreachable;
+    options.nearestFirst = NearestFirst;
+    options.stopAtWitness = StopAtWitness;
+    options.mergeStates = MergeStates;
+    options.scheduler = Scheduler;
+    options.schedulerSeed = SchedulerSeed;
+    options.numThreads = ExploreThreads;
+    options.maxLoopUnroll = MaxLoopUnroll;
+    options.maxNodeVisits = MaxNodeVisits;
+    options.maxPathDepth = MaxPathDepth;
+    options.maxSummaryPaths = MaxSummaryPaths;
+    options.maxMergePaths = MaxMergePaths;
+    options.theory = Encoding;
+    options.solverLimits.timeout = SolverTimeout;
+    options.solverLimits.rlimit = SolverRlimit;
+    options.budget = budget;
+    options.queryCache = queryCache;
+    options.exploredGraph = exploredGraph;
+    options.profiler = profiler;
+    return options;
+}
 
-            if (expr_str_to_idx_map.find(firstOperand) == expr_str_to_idx_map.end()) {
-                expr_str_to_idx_map[firstOperand] = expr_list.size();
-                expr_list.push_back(c.int_const(firstOperand.c_str()));
-            }
 
-            int firstOperandIdx = expr_str_to_idx_map[firstOperand];
-            auto first_expr_it = expr_list.begin();
-            std::advance(first_expr_it, firstOperandIdx);
-            expr first_expr = *first_expr_it;
+/**
+ * Accepts the ICFG along with function root ID and target node ID to return a summary of whether or not is the target
+ * node reachable. Every path from the root to the target is explored symbolically and reported; paths running into
+ * the loop, visit or depth bounds are reported as bounded, and an exhausted budget leaves the answer unknown.
+ *
+ * @param icfg          ICFG graph from svf-tools
+ * @param functionRoot  Node ID of the function root
+ * @param targetNode    Node ID of the target node
+ * @param reporter      Receives the outcome of every path reaching the target
+ * @param options       Exploration options, with the caches, subgraph, budget and profiler shared by the whole run
+ * @return              Path counts denoting the reachability of the target node.
+ */
+ExplorationSummary checkReachabilityForFunction(ICFG* icfg, int functionRoot, int targetNode, PathReporter& reporter,
+                                                const ExplorerOptions& options) {
+    PathExplorer explorer(icfg, options, reporter);
+    return explorer.explore(functionRoot, targetNode);
+}
 
-            expr second_expr = c.int_const("whoo");
-            if (!is_number(secondOperand)) {
-                if (expr_str_to_idx_map.find(secondOperand) == expr_str_to_idx_map.end()) {
-                    expr_str_to_idx_map[secondOperand] = expr_list.size();
-                    expr_list.push_back(c.int_const(secondOperand.c_str()));
-                }
-                int secondOperandIdx = expr_str_to_idx_map[secondOperand];
-                auto second_expr_it = expr_list.begin();
-                std::advance(second_expr_it, secondOperandIdx);
-                second_expr = *second_expr_it;
-            }
 
-            if (!is_number(secondOperand)) {
-                replace_element_at_idx(expr_list, firstOperandIdx, second_expr);
-//                expr_list.erase(first_expr_it);
-//                if (firstOperandIdx == expr_list.size()) {
-//                    expr_list.push_back(second_expr);
-//                } else {
-//                    first_expr_it = expr_list.begin();
-//                    std::advance(first_expr_it, firstOperandIdx);
-//                    expr_list.insert(first_expr_it, second_expr);
-//                }
-            } else {
-                constraints.push_back(first_expr == stoi(secondOperand));
+/**
+ * Checks whether the exit of every selected function is reachable from its entry.
+ *
+ * @param resultCache  Results of earlier runs, replayed for the functions that did not change and updated with those
+ *                     of the others; may be null. Nothing is replayed when a subgraph is collected, which needs the
+ *                     explored edges.
+ */
+void analyzeFunctions(ICFG* icfg, PathReporter& reporter, const ExplorerOptions& options,
+                      FunctionResultCache* resultCache) {
+    FunctionIndex functionIndex(icfg);
+    std::vector<string> functions = selectFunctions(functionIndex);
+    unsigned reachableFunctions = 0;
+    unsigned unknownFunctions = 0;
+    Profiler::Counters counters;
+    std::vector<PathResult> recorded;
+    for (const string& function_name : functions) {
+        reporter.beginFunction(function_name);
+        int functionRoot = functionIndex.getEntry(function_name);
+        int functionExit = functionIndex.getExit(function_name);
+        const Function* fun = icfg->getICFGNode(functionRoot)->getFun()->getLLVMFun();
+        uint64_t hash = resultCache != nullptr ? resultCache->getHash(fun) : 0;
+        ExplorationSummary summary;
+        if (resultCache != nullptr && options.exploredGraph == nullptr
+                && resultCache->replay(fun, hash, reporter, summary)) {
+            counters.count(Profiler::FunctionsReused);
+        } else {
+            recorded.clear();
+            reporter.setRecorder(resultCache != nullptr ? &recorded : nullptr);
+            summary = checkReachabilityForFunction(icfg, functionRoot, functionExit, reporter, options);
+            reporter.setRecorder(nullptr);
+            if (resultCache != nullptr) {
+                resultCache->record(fun, hash, recorded, summary);
             }
-
-            //secondOperand = firstOperand
-//            cout << "Whoo!" << endl;
-//            cout << firstOperand << "=" << secondOperand << endl;
         }
-    }
-//    for (const auto & it : expr_str_to_idx_map) {
-//        cout << it.first << " " << it.second << "\n";
-//    }
-//    for (const auto & curr_expr : expr_list) {
-//        cout << curr_expr << "\n";
-//    }
-
-    // Printing results
-    cout << "Current Path (in Node ID's): ";
-    for (const ICFGNode* currNode : nodeList) {
-        if (currNode != nodeList.back()) {
-            cout << currNode->getId() << " -> ";
-        } else {
-            cout << currNode->getId() << endl;
+        reporter.endFunction(summary);
+        if (summary.isReachable()) {
+            reachableFunctions++;
+        } else if (summary.isBounded()) {
+            unknownFunctions++;
         }
     }
-
-    // Adding constraints
-    solver s(c);
-    cout << "Constraints:" << endl;
-    for (const auto & curr_expr : constraints) {
-        s.add(curr_expr);
-        cout << curr_expr << endl;
+    reporter.reportTotals(functions.size(), reachableFunctions, unknownFunctions);
+    if (options.profiler != nullptr) {
+        options.profiler->merge(counters);
     }
+}
 
-    cout << "Reachable: ";
-
-    switch(s.check()) {
-        case z3::sat: {
-            cout << "Yes" << endl;
-
-            cout << "Satisfiability Values (Variable Name = Value):" << endl;
-            model m = s.get_model();
-            for (int i = 0; i < m.size(); i++) {
-                func_decl v = m[i];
-                string var_name = v.name().str();
-                cout << var_name.substr(1, var_name.size() - 1) << " = " << m.get_const_interp(v) << endl;
-            }
 
-            cout << EQUALS_STRING << endl;
-            return true;
+/**
+ * Answers every query in one pass per source: the paths from a source are explored once, towards all of its targets.
+ * Sources are answered in the order they first appear, and their targets likewise.
+ *
+ * @param queries  Source/target pairs, as given on the command line or in the query file
+ */
+void answerQueries(ICFG* icfg, const std::vector<ReachabilityQuery>& queries, PathReporter& reporter,
+                   const ExplorerOptions& options) {
+    struct QueryGroup {
+        NodeID source;
+        string sourceName;
+        std::vector<NodeID> targets;
+        std::vector<string> targetNames;
+    };
+
+    LocationIndex locationIndex(icfg);
+    std::vector<QueryGroup> groups;
+    std::unordered_map<NodeID, unsigned> groupOfSource;
+    for (const ReachabilityQuery& query : queries) {
+        int source = locationIndex.resolve(query.source);
+        int target = locationIndex.resolve(query.target);
+        if (source < 0 || target < 0) {
+            cerr << "Skipping query " << query.source << "," << query.target << ": "
+                 << (source < 0 ? query.source : query.target) << " names no ICFG node" << endl;
+            continue;
         }
-        case z3::unsat: {
-            cout << "No" << endl;
-            cout << EQUALS_STRING << endl;
-            return false;
+        // Calls are stepped over through summaries, so paths never leave the function of the source
+        if (icfg->getICFGNode(source)->getFun() != icfg->getICFGNode(target)->getFun()) {
+            cerr << "Skipping query " << query.source << "," << query.target
+                 << ": the target is not in the function of the source" << endl;
+            continue;
         }
-        case z3::unknown: {
-            cout << "Unsure" << endl;
-            cout << EQUALS_STRING << endl;
-            return false;
+        auto it = groupOfSource.insert(std::make_pair(source, groups.size()));
+        if (it.second) {
+            groups.push_back(QueryGroup{(NodeID) source, query.source, {}, {}});
         }
-        default: {
-            cout << "Unsure" << endl;
-            cout << EQUALS_STRING << endl;
-            return false;
+        QueryGroup& group = groups[it.first->second];
+        if (std::find(group.targets.begin(), group.targets.end(), (NodeID) target) == group.targets.end()) {
+            group.targets.push_back(target);
+            group.targetNames.push_back(query.target);
         }
     }
-}
 
-
-/**
- * Accepts the ICFG along with function root ID and target node ID to return a boolean value representing whether or not
- * is the target node reachable.
- * TODO: Add support for getting inputs needed to reach the target node.
- *
- * @param icfg          ICFG graph from svf-tools
- * @param functionRoot  Node ID of the function root
- * @param targetNode    Node ID of the target node
- * @return              Boolean value denoting the reachability of the target node.
- */
-bool checkReachabilityForFunction(ICFG* icfg, int functionRoot, int targetNode) {
-    const ICFGNode* iNode = icfg->getICFGNode(functionRoot);
-    std::list<const ICFGNode*> worklist;  // FILOList
-    std::list<const ICFGNode*> emptyList;
-    std::list<bool> emptyBoolList;
-    std::list<std::list<const ICFGNode*>> pathList;  // FILOList, keeps track of how we got to the current node
-    std::list<std::list<bool>> branchList;  // FILOList, keeps track of branching off
-    worklist.push_back(iNode);
-    pathList.push_back(emptyList);
-    branchList.push_back(emptyBoolList);
-
-    bool upcomingSplit = false;
-
-    while (!worklist.empty()) {
-        const ICFGNode* vNode = worklist.back();
-        worklist.pop_back();
-        std::list<const ICFGNode*> currPathList = pathList.back();
-        pathList.pop_back();
-//        if ((int) vNode->getId() != functionRoot) {
-//            cout << vNode->toString() << "==================\n";
-//        }
-
-        int cmpTracker = -1;  // -1 -> dw, 0 -> false, 1 -> true
-
-        std::list<bool> currBranchTracker;
-        if (upcomingSplit) {
-            cmpTracker = 1;
-            currBranchTracker = branchList.back();
-            branchList.pop_back();
-        }
-
-        for (auto it = vNode->OutEdgeBegin(); it != vNode->OutEdgeEnd(); ++it) {
-            if (cmpTracker >= 0) {
-                std::list<bool> newBranchList = std::list<bool>(currBranchTracker);
-                if (cmpTracker == 0) {
-                    newBranchList.push_back(false);
-                } else {
-                    newBranchList.push_back(true);
-                }
-                branchList.push_back(newBranchList);
-                cmpTracker -= 1;
-            }
-            ICFGEdge* edge = *it;
-            ICFGNode* succNode = edge->getDstNode();
-            if (succNode->getId() == targetNode) {
-//                cout << currPathList.size() << "\n";  // Path leading to the target node
-                std::list<bool> currBranchList = branchList.back();
-                branchList.pop_back();
-
-                if (checkPathFeasibility(currPathList, currBranchList)) {
-//                    return true;
-                }
-                continue;
+    unsigned answered = 0;
+    unsigned reachable = 0;
+    unsigned unknown = 0;
+    PathExplorer explorer(icfg, options, reporter);
+    for (const QueryGroup& group : groups) {
+        reporter.beginSource(group.sourceName);
+        std::vector<ExplorationSummary> outcomes = explorer.explore(group.source, group.targets);
+        for (unsigned i = 0; i < group.targets.size(); i++) {
+            reporter.reportTarget(group.targetNames[i], outcomes[i]);
+            answered++;
+            if (outcomes[i].isReachable()) {
+                reachable++;
+            } else if (outcomes[i].isBounded()) {
+                unknown++;
             }
-            worklist.push_back(succNode);
-            std::list<const ICFGNode*> newPathList = std::list<const ICFGNode*>(currPathList);
-            newPathList.push_back(succNode);
-            pathList.push_back(newPathList);
-//            cout << pathList.size() << "\n";
-        }
-
-        if (vNode->toString().find("icmp") != string::npos) {
-            upcomingSplit = true;
-        } else {
-            upcomingSplit = false;
         }
     }
-    return false;
+    reporter.reportQueryTotals(answered, reachable, unknown);
 }
 
 
 int main(int argc, char ** argv) {
-    //file to write mathematical constraints taken from the ICFG
-    MyFile.open("constraints.txt");
-
     int arg_num = 0;
     char **arg_value = new char*[argc];
     std::vector<std::string> moduleNameVec;
@@ -679,57 +629,118 @@ int main(int argc, char ** argv) {
     cl::ParseCommandLineOptions(arg_num, arg_value,
                                 "Whole Program Points-to Analysis\n");
 
-    SVFModule* svfModule = LLVMModuleSet::getLLVMModuleSet()->buildSVFModule(moduleNameVec);
-    svfModule->buildSymbolTableInfo();
+    std::unique_ptr<Profiler> profiler;
+    if (Profile || !ProfileJson.empty() || !ProfileTrace.empty()) {
+        profiler.reset(new Profiler());
+    }
+
+    SVFModule* svfModule;
+    {
+        Profiler::Span span(profiler.get(), "module load", 0, Profiler::ModuleLoad);
+        svfModule = LLVMModuleSet::getLLVMModuleSet()->buildSVFModule(moduleNameVec);
+    }
+    {
+        Profiler::Span span(profiler.get(), "symbol table", 0, Profiler::SymbolTable);
+        svfModule->buildSymbolTableInfo();
+    }
     
 	/// Build Program Assignment Graph (PAG)
 		PAGBuilder builder;
-		PAG *pag = builder.build(svfModule);
+		PAG *pag;
+		{
+			Profiler::Span span(profiler.get(), "PAG build", 0, Profiler::PAGBuild);
+			pag = builder.build(svfModule);
+		}
 
 		/// ICFG
 		ICFG *icfg = pag->getICFG();
-        int functionRoot = findRoot(icfg,"foo", "Entry");
-		icfg->dump("icfg");
-        int functionExit = findRoot(icfg,"foo", "Exit");
-        checkReachabilityForFunction(icfg, functionRoot, functionExit);
-
-
-        //Z3 solver trial
-        //http://www.cs.utah.edu/~vinu/research/formal/tools/notes/z3-notes.html#sec-z3-c-interface-cheat-sheet
-//        context c;
-//        expr x = c.int_const("x");
-//        expr y = c.int_const("y");
-//        solver s(c);
-//
-//        s.add(x >= 1);
-//        s.add(y < x + 3);
-//        std::cout << s.check() << "\n";
-//
-//        model m = s.get_model();
-//        std::cout << m << "\n";
-//
-//        // traversing the model
-//        for (unsigned i = 0; i < m.size(); i++) {
-//            func_decl v = m[i];
-//            assert(v.arity() == 0);
-//
-//            std::cout << v.name() << " = " << m.get_const_interp(v) << "\n";
-//        }
-//
-//        // we can evaluate expressions in the model.
-//        std::cout << "x + y + 1 = " << m.eval(x + y + 1) << "\n";
-//
-//            // STEP-3 checks if the result is unsat.
-//            switch (s.check()) {
-//                case unsat:   std::cout << "de-Morgan is valid\n"; break;
-//                case sat:     std::cout << "de-Morgan is not valid\n"; break;
-//                case unknown: std::cout << "unknown\n"; break;
-//            }
-
+		if (DumpICFG) {
+			icfg->dump("icfg");
+		}
+
+        ofstream outputFile;
+        if (!OutputFile.empty()) {
+            outputFile.open(OutputFile, OutputFormat == PathReporter::BinaryOutput ? ios::binary : ios::out);
+            if (!outputFile) {
+                cerr << "Could not open " << OutputFile << endl;
+                return 1;
+            }
+        }
+        //file to write mathematical constraints taken from the ICFG
+        ofstream constraintsFile;
+        if (!ConstraintsFile.empty()) {
+            constraintsFile.open(ConstraintsFile);
+        }
+        PathReporter reporter(OutputFile.empty() ? cout : outputFile,
+                              constraintsFile.is_open() ? &constraintsFile : nullptr, OutputFormat);
+        QueryCache queryCache;
+        SummaryTable summaryTable;
+        ExploredGraph exploredGraph(DumpSubgraphScope);
+        if (CacheQueries && !QueryCacheFile.empty() && !queryCache.load(QueryCacheFile)) {
+            cerr << "Starting with an empty query cache, could not read " << QueryCacheFile << endl;
+        }
 
+        /// The budget counts from here, building the ICFG is not charged to it
+        std::unique_ptr<ResourceBudget> budget;
+        if (TimeBudget > 0 || MemoryBudget > 0) {
+            budget.reset(new ResourceBudget(TimeBudget, MemoryBudget));
+        }
+        ExplorerOptions options = getExplorerOptions(CacheQueries ? &queryCache : nullptr,
+                                                     DumpSubgraph.empty() ? nullptr : &exploredGraph, budget.get(),
+                                                     profiler.get());
+        std::unique_ptr<MemoryRegions> regions;
+        {
+            Profiler::Span span(profiler.get(), "points-to", 0, Profiler::PointsTo);
+            regions = buildMemoryRegions(moduleNameVec, icfg, pag);
+        }
+        options.memoryRegions = regions.get();
+        /// Callees are summarized once for every function and query of the run
+        options.summaryTable = &summaryTable;
+
+        /// Queries or every selected function are analyzed against the same SVFModule/PAG/ICFG
+        std::vector<ReachabilityQuery> queries;
+        if (!readQueries(queries)) {
+            cerr << "Could not read " << QueryFile << endl;
+            return 1;
+        }
+        if (!Queries.empty() || !QueryFile.empty()) {
+            answerQueries(icfg, queries, reporter, options);
+        } else {
+            std::unique_ptr<FunctionResultCache> resultCache;
+            if (!IncrementalCache.empty()) {
+                resultCache.reset(new FunctionResultCache(icfg, *regions,
+                        FunctionResultCache::hashOptions(options, reporter.reportsPaths())));
+                if (!resultCache->load(IncrementalCache)) {
+                    cerr << "Exploring every function, could not read " << IncrementalCache << endl;
+                }
+            }
+            analyzeFunctions(icfg, reporter, options, resultCache.get());
+            if (resultCache && !resultCache->save(IncrementalCache)) {
+                cerr << "Could not write the incremental cache to " << IncrementalCache << endl;
+            }
+        }
+        if (CacheQueries && !QueryCacheFile.empty() && !queryCache.save(QueryCacheFile)) {
+            cerr << "Could not write the query cache to " << QueryCacheFile << endl;
+        }
+        if (!DumpSubgraph.empty() && !exploredGraph.write(icfg, DumpSubgraph)) {
+            cerr << "Could not write the subgraph to " << DumpSubgraph << endl;
+        }
+        if (Profile) {
+            profiler->printSummary(cerr);
+        }
+        if (!ProfileJson.empty() && !profiler->writeJson(ProfileJson)) {
+            cerr << "Could not write the profile to " << ProfileJson << endl;
+        }
+        if (!ProfileTrace.empty() && !profiler->writeTrace(ProfileTrace)) {
+            cerr << "Could not write the trace to " << ProfileTrace << endl;
+        }
+        if (UsePointsTo) {
+            AndersenWaveDiff::releaseAndersenWaveDiff();
+        }
 
-		LLVMModuleSet::getLLVMModuleSet()->dumpModulesToFile(".svf.bc");
-        MyFile.close();
+        if (EmitBitcode) {
+            LLVMModuleSet::getLLVMModuleSet()->dumpModulesToFile(".svf.bc");
+        }
 
 
     return 0;
@@ -0,0 +1,119 @@
+//===- ConstraintSlicerTest.cpp -- Clusters of a growing and shrinking path -//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+#include "ConstraintSlicer.h"
+#include "TestUtil.h"
+#include <random>
+
+using namespace z3;
+
+namespace {
+
+typedef std::vector<ConstraintSlicer::Cluster> Partition;
+
+Partition clusters(std::initializer_list<ConstraintSlicer::Cluster> list) {
+    return Partition(list);
+}
+
+
+void testClusters() {
+    context ctx;
+    expr x = ctx.int_const("%x");
+    expr y = ctx.int_const("%y");
+    expr z = ctx.int_const("%z");
+    std::vector<SlicedConstraint> path;
+    path.emplace_back(x > 0, true);
+    path.emplace_back(y > 0, true);
+    path.emplace_back(x + 1 > 0 || y == 0, true);  // Joins the clusters of x and y
+    path.emplace_back(z == 3, true);
+    path.emplace_back(x == x, true);               // Simplifies to true, so belongs to no cluster
+    ConstraintSlicer slicer;
+    for (const SlicedConstraint& constraint : path) {
+        slicer.add(constraint);
+    }
+    CHECK(path[4].isTrivial());
+    CHECK(slicer.partition() == clusters({{0, 1, 2}, {3}}));
+    CHECK(slicer.slice(1) == ConstraintSlicer::Cluster({0, 1, 2}));
+    CHECK(slicer.slice(3) == ConstraintSlicer::Cluster({3}));
+    CHECK(slicer.slice(4).empty());
+
+    // Dropping the joining constraint splits the cluster again
+    slicer.truncate(2);
+    CHECK(slicer.size() == 2);
+    CHECK(slicer.partition() == clusters({{0}, {1}}));
+    slicer.add(path[3]);
+    CHECK(slicer.partition() == clusters({{0}, {1}, {2}}));
+}
+
+
+/**
+ * Grows and backtracks a path at random, as the explorer does, and compares the slicer kept up to date with the undo
+ * log against one built from scratch for the same constraints after every step.
+ */
+void testUndoLog() {
+    context ctx;
+    std::vector<expr> symbols;
+    for (unsigned i = 0; i < 8; i++) {
+        symbols.push_back(ctx.int_const(("%s" + std::to_string(i)).c_str()));
+    }
+    std::mt19937 random(1);
+    auto pick = [&random, &symbols]() {
+        return symbols[random() % symbols.size()];
+    };
+    std::vector<SlicedConstraint> path;
+    ConstraintSlicer slicer;
+    for (unsigned step = 0; step < 2000; step++) {
+        if (path.empty() || random() % 3 != 0) {
+            // Mostly constraints on one or two symbols, sometimes one on three or a trivial one
+            unsigned shape = random() % 8;
+            expr constraint = shape == 0 ? pick() + pick() + pick() > 1
+                            : shape == 1 ? pick() == pick()
+                            : shape == 2 ? ctx.bool_val(true) || pick() > 0
+                            : shape < 5 ? pick() - pick() < 4
+                                        : pick() > (int) (random() % 10);
+            path.emplace_back(constraint, true);
+            slicer.add(path.back());
+        } else {
+            path.erase(path.begin() + random() % path.size(), path.end());
+            slicer.truncate(path.size());
+        }
+
+        ConstraintSlicer rebuilt;
+        for (const SlicedConstraint& constraint : path) {
+            rebuilt.add(constraint);
+        }
+        CHECK(slicer.size() == path.size());
+        CHECK(slicer.partition() == rebuilt.partition());
+        for (unsigned i = 0; i < path.size(); i++) {
+            CHECK(slicer.slice(i) == rebuilt.slice(i));
+        }
+    }
+}
+
+} // End anonymous namespace
+
+
+int main() {
+    testClusters();
+    testUndoLog();
+    return testResult();
+}
@@ -0,0 +1,128 @@
+//===- QueryCacheTest.cpp -- Hashing, lookups and files of the query cache -//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+#include "QueryCache.h"
+#include "TestUtil.h"
+#include <cstdio>
+#include <fstream>
+
+using namespace z3;
+
+namespace {
+
+const char* const CACHE_FILE = "QueryCacheTest.cache";
+
+QueryCache::Query makeQuery(std::initializer_list<QueryCache::ConstraintHash> hashes) {
+    QueryCache::Query query(hashes);
+    QueryCache::normalize(query);
+    return query;
+}
+
+
+/// Equal constraints hash alike in any context, and the operand order, sorts and decl parameters all count
+void testHashConstraint() {
+    context first;
+    context second;
+    expr x1 = first.int_const("%x");
+    expr y1 = first.int_const("%y");
+    expr x2 = second.int_const("%x");
+    expr y2 = second.int_const("%y");
+    CHECK(QueryCache::hashConstraint(x1 - y1 > 3) == QueryCache::hashConstraint(x2 - y2 > 3));
+    CHECK(QueryCache::hashConstraint(x1 - y1 > 3) != QueryCache::hashConstraint(y1 - x1 > 3));
+    CHECK(QueryCache::hashConstraint(x1 - y1 > 3) != QueryCache::hashConstraint(x1 - y1 > 4));
+
+    // A subexpression used twice hashes like two copies of it
+    expr sum = x1 + y1;
+    CHECK(QueryCache::hashConstraint(sum * sum == 4) == QueryCache::hashConstraint((x1 + y1) * (x1 + y1) == 4));
+
+    expr bv = first.bv_const("%x", 32);
+    CHECK(QueryCache::hashConstraint(x1 == 1) != QueryCache::hashConstraint(bv == first.bv_val(1, 32)));
+    CHECK(QueryCache::hashConstraint(bv.extract(7, 0) == 0) != QueryCache::hashConstraint(bv.extract(15, 8) == 0));
+}
+
+
+void testNormalize() {
+    QueryCache::Query query = {3, 1, 2, 3, 1};
+    QueryCache::normalize(query);
+    CHECK(query == QueryCache::Query({1, 2, 3}));
+}
+
+
+void testLookup() {
+    QueryCache cache;
+    check_result verdict = unknown;
+    QueryCache::Model model;
+    CHECK(!cache.lookup(makeQuery({1, 2}), verdict, nullptr));
+
+    cache.insertSat(makeQuery({1, 2}), nullptr);
+    CHECK(cache.lookup(makeQuery({1, 2}), verdict, nullptr) && verdict == sat);
+    // A model was not kept, so a lookup asking for one misses
+    CHECK(!cache.lookup(makeQuery({1, 2}), verdict, &model));
+    QueryCache::Model kept = {{"x", "1"}, {"y", "-2"}};
+    cache.insertSat(makeQuery({1, 2}), &kept);
+    CHECK(cache.lookup(makeQuery({1, 2}), verdict, &model) && verdict == sat && model == kept);
+
+    // Any query containing a known core is UNSAT, whatever else it contains
+    cache.insertUnsat(makeQuery({4, 5, 6}), makeQuery({4, 6}));
+    CHECK(cache.lookup(makeQuery({4, 5, 6}), verdict, nullptr) && verdict == unsat);
+    CHECK(cache.lookup(makeQuery({0, 4, 6, 9}), verdict, nullptr) && verdict == unsat);
+    CHECK(!cache.lookup(makeQuery({4, 5}), verdict, nullptr));
+    CHECK(cache.getHits() == 4 && cache.getMisses() == 3);
+}
+
+
+/// Everything a cache answers before it is saved, a cache loaded from the file answers alike
+void testRoundTrip() {
+    QueryCache saved;
+    QueryCache::Model kept = {{"x", "7"}, {"name with spaces", "(- 1)"}};
+    saved.insertSat(makeQuery({10, 20}), &kept);
+    saved.insertSat(makeQuery({30}), nullptr);
+    saved.insertUnsat(makeQuery({40, 50, 60}), makeQuery({40, 60}));
+    CHECK(saved.save(CACHE_FILE));
+
+    QueryCache loaded;
+    CHECK(loaded.load(CACHE_FILE));
+    check_result verdict = unknown;
+    QueryCache::Model model;
+    CHECK(loaded.lookup(makeQuery({10, 20}), verdict, &model) && verdict == sat && model == kept);
+    CHECK(loaded.lookup(makeQuery({30}), verdict, nullptr) && verdict == sat);
+    CHECK(!loaded.lookup(makeQuery({30}), verdict, &model));
+    CHECK(loaded.lookup(makeQuery({40, 50, 60}), verdict, nullptr) && verdict == unsat);
+    CHECK(loaded.lookup(makeQuery({40, 45, 60}), verdict, nullptr) && verdict == unsat);
+
+    // A file of another format is rejected instead of being misread
+    std::ofstream(CACHE_FILE) << "svf-ex-query-cache 0\nsat 1 10 -1\n";
+    QueryCache stale;
+    CHECK(!stale.load(CACHE_FILE));
+    std::remove(CACHE_FILE);
+}
+
+} // End anonymous namespace
+
+
+int main() {
+    testHashConstraint();
+    testNormalize();
+    testLookup();
+    testRoundTrip();
+    return testResult();
+}
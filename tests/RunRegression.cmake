@@ -0,0 +1,40 @@
+# Runs svf-ex on INPUT with OPTIONS and -output-format=quiet, and compares the counts it prints with EXPECTED.
+#
+# With CACHE_OPTION (e.g. -query-cache-file), svf-ex runs twice with that option naming a cache file that does not
+# exist yet, so the second run starts from what the first one saved. Both runs must print the expected counts, and
+# the stderr of the second run must match SECOND_STDERR if given, which -profile lets a test check cache hits with.
+# With SECOND_INPUT and SECOND_EXPECTED, the second run is on an edited input instead, which checks that the cache
+# does not answer for what changed.
+
+file(MAKE_DIRECTORY ${WORK_DIR})
+file(READ ${EXPECTED} expected)
+
+set(runs 1)
+if (CACHE_OPTION)
+    set(cacheFile ${WORK_DIR}/cache)
+    file(REMOVE ${cacheFile})
+    list(APPEND OPTIONS ${CACHE_OPTION}=${cacheFile})
+    set(runs 2)
+endif()
+
+foreach(run RANGE 1 ${runs})
+    if (run EQUAL 2 AND SECOND_INPUT)
+        set(INPUT ${SECOND_INPUT})
+        file(READ ${SECOND_EXPECTED} expected)
+    endif()
+    execute_process(COMMAND ${SVF_EX} -output-format=quiet ${OPTIONS} ${INPUT}
+                    WORKING_DIRECTORY ${WORK_DIR}
+                    RESULT_VARIABLE status
+                    OUTPUT_VARIABLE output
+                    ERROR_VARIABLE errors)
+    if (NOT status EQUAL 0)
+        message(FATAL_ERROR "Run ${run} exited with ${status}:\n${errors}")
+    endif()
+    if (NOT output STREQUAL expected)
+        message(FATAL_ERROR "Run ${run} printed\n${output}\ninstead of\n${expected}")
+    endif()
+endforeach()
+
+if (DEFINED SECOND_STDERR AND NOT errors MATCHES "${SECOND_STDERR}")
+    message(FATAL_ERROR "Stderr of the last run does not match ${SECOND_STDERR}:\n${errors}")
+endif()
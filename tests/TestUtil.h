@@ -0,0 +1,54 @@
+//===- TestUtil.h -- Checks shared by the unit test drivers ----------------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+/*
+ * Every driver is a plain executable run by ctest: CHECK reports each failed condition and keeps going, and main
+ * returns testResult(), which is nonzero if any check failed.
+ */
+
+#ifndef TESTUTIL_H_
+#define TESTUTIL_H_
+
+#include <iostream>
+
+inline unsigned& failedChecks() {
+    static unsigned failed = 0;
+    return failed;
+}
+
+#define CHECK(condition)                                                                   \
+    do {                                                                                   \
+        if (!(condition)) {                                                                \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed\n"; \
+            failedChecks()++;                                                              \
+        }                                                                                  \
+    } while (0)
+
+inline int testResult() {
+    if (failedChecks() > 0) {
+        std::cerr << failedChecks() << " check(s) failed\n";
+        return 1;
+    }
+    return 0;
+}
+
+#endif /* TESTUTIL_H_ */